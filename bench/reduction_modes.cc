@@ -0,0 +1,65 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+// best time in seconds of repetitions of resampling the data and computing the error of the mean
+double best_time(reduction_mode mode, const std::vector<double>& x, std::size_t repetitions, double& sigma) {
+	double best = 0;
+	for (std::size_t r = 0; r < repetitions; ++r) {
+		const auto start = std::chrono::steady_clock::now();
+		JackknifeAnalyzer<std::string, double> analyzer;
+		analyzer.set_reduction_mode(mode);
+		analyzer.resample("x", x);
+		sigma = analyzer.sigma("x");
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (r == 0 || seconds < best)
+			best = seconds;
+	}
+	return best;
+}
+
+}
+
+/**
+ * Times resample(...) and sigma(...) of a single variable in each reduction mode, with one bin per sample, i.e. sums
+ * over all samples and all bins. Usage: bench_reduction_modes [number of samples = 2^24] [repetitions = 5]
+ */
+int main(int argc, char** argv) {
+	const std::size_t N_samples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 24;
+	const std::size_t repetitions = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+	std::vector<double> x(N_samples);
+	for (std::size_t i = 0; i < N_samples; ++i)
+		x[i] = 1 + 0.1 * std::sin(0.37 * i);
+
+#ifdef _OPENMP
+	const int num_threads = omp_get_max_threads();
+#else
+	const int num_threads = 1;
+#endif
+	std::printf("%zu samples, %d threads, best of %zu\n", N_samples, num_threads, repetitions);
+
+	const char* names[] = { "sequential", "reproducible", "fast" };
+	const reduction_mode modes[] = { reduction_mode::sequential, reduction_mode::reproducible, reduction_mode::fast };
+	double sequential_time = 0;
+	for (std::size_t m = 0; m < 3; ++m) {
+		double sigma;
+		const double seconds = best_time(modes[m], x, repetitions, sigma);
+		if (m == 0)
+			sequential_time = seconds;
+		std::printf("%-12s %8.1f ms %6.2f x sequential  sigma = %.17g\n", names[m], 1e3 * seconds,
+				seconds / sequential_time, sigma);
+	}
+	return 0;
+}
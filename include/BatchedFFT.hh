@@ -0,0 +1,63 @@
+#ifndef INCLUDE_BATCHEDFFT_HH_
+#define INCLUDE_BATCHEDFFT_HH_
+
+#include <vector>
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Multi-dimensional discrete Fourier transform of a batch of complex arrays of arithmetic type T,
+ * F(k) = sum_x f(x) exp(sign * 2 pi i sum_d k_d x_d / extents[d]), without normalization.
+ *
+ * Points x are numbered row-major over the extents. The data of all arrays of the batch is stored point-major with
+ * the batch index innermost, so every butterfly operates on contiguous vectors of batch values, e.g. one value per
+ * jackknife bin. Axes with a power of 2 extent use the iterative radix-2 algorithm, other axes a direct DFT.
+ * Twiddle factors are computed once in the constructor, so transform(...) can be called concurrently.
+ */
+template<typename T>
+class BatchedFFT {
+public:
+
+	/**
+	 * Prepare transforms over the given extents with the given sign of the exponent (-1 or 1).
+	 * Throws if there is no extent, an extent is 0 or sign is neither -1 nor 1.
+	 */
+	BatchedFFT(const std::vector<std::size_t>& extents, int sign = -1);
+
+	/**
+	 * Returns the number of points, i.e. the product of the extents.
+	 */
+	std::size_t size() const;
+
+	/**
+	 * Transforms the batch of arrays with real parts re and imaginary parts im (size() x batch values each, batch
+	 * index innermost) in place. Lines along each axis are processed in parallel if OpenMP is enabled.
+	 */
+	void transform(T* re, T* im, std::size_t batch) const;
+
+private:
+
+	struct axis {
+		std::size_t length;
+		std::size_t stride; // in points
+		bool radix_2;
+		std::vector<T> twiddle_re, twiddle_im; // exp(sign * 2 pi i j / length), j < length
+	};
+
+	std::size_t N_points;
+	std::vector<axis> axes;
+
+	void transform_line(const axis& a, T* re, T* im, std::size_t batch) const;
+
+};
+
+}
+}
+}
+
+#include <detail/BatchedFFT.tcc>
+
+#endif /* INCLUDE_BATCHEDFFT_HH_ */
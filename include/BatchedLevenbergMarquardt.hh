@@ -0,0 +1,70 @@
+#ifndef INCLUDE_BATCHEDLEVENBERGMARQUARDT_HH_
+#define INCLUDE_BATCHEDLEVENBERGMARQUARDT_HH_
+
+#include <vector>
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Levenberg-Marquardt solver for uncorrelated nonlinear least-squares fits of the same model to W data sets at once,
+ * e.g. to W jackknife bins. The data sets are advanced in lockstep: parameters, normal equations and damping are stored
+ * with the data set ("lane") as innermost index, so the accumulation of the normal equations, their solution and the
+ * parameter updates are vectorized across lanes. Converged lanes are masked and keep their parameters while the
+ * remaining lanes continue.
+ *
+ * A model is a callable T model(std::size_t t, const T* params, T* gradient) which returns the model value at data point
+ * t for the parameters params and assigns its derivatives with respect to the parameters to gradient.
+ * It is called once per lane and data point, with params of that lane.
+ */
+template<typename T, std::size_t W = 8>
+class BatchedLevenbergMarquardt {
+public:
+
+	static constexpr std::size_t lanes = W;
+
+	/**
+	 * Prepare fits of num_parameters parameters to num_points data points with errors sigmas.
+	 * A lane stops when the relative decrease of chi^2 in an accepted step is below tolerance or after max_iterations.
+	 * Throws if the number of sigmas does not match num_points.
+	 */
+	BatchedLevenbergMarquardt(std::size_t num_points, std::size_t num_parameters, const std::vector<T>& sigmas,
+			std::size_t max_iterations = 100, T tolerance = 1e-10);
+
+	/**
+	 * Fits the model to num_lanes <= W data sets, where y_columns[t][l] is data point t of lane l, i.e. the lanes of
+	 * each data point are contiguous as in consecutive jackknife samples of a variable.
+	 * params (num_parameters x W, lane innermost) holds the initial guess on input and the fit result on output;
+	 * chi2 (W values), if not null, is assigned the final chi^2 of each lane.
+	 * Lanes where the model does not depend on a parameter at any data point, i.e. where the normal matrix has a zero
+	 * diagonal element, stop as soon as this occurs and are assigned NaN parameters.
+	 */
+	template<typename Model>
+	void solve(Model& model, const T* const * y_columns, std::size_t num_lanes, T* params, T* chi2 = nullptr) const;
+
+	std::size_t num_points() const;
+	std::size_t num_parameters() const;
+
+private:
+
+	std::size_t N_points;
+	std::size_t N_params;
+	std::vector<T> inverse_sigmas;
+	std::size_t max_iterations;
+	T tolerance;
+
+	template<typename Model>
+	void evaluate(Model& model, const T* const * y_columns, const std::vector<char>& active, const T* params,
+			T* chi2, T* JtJ, T* Jtr) const;
+
+};
+
+}
+}
+}
+
+#include <detail/BatchedLevenbergMarquardt.tcc>
+
+#endif /* INCLUDE_BATCHEDLEVENBERGMARQUARDT_HH_ */
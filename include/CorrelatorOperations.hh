@@ -0,0 +1,68 @@
+#ifndef INCLUDE_CORRELATOROPERATIONS_HH_
+#define INCLUDE_CORRELATOROPERATIONS_HH_
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+namespace correlator {
+
+/**
+ * Sparse linear map between time slices: output i is the sum of weight * input index over the pairs in entry i.
+ */
+template<typename T>
+using linear_terms = std::vector<std::vector<std::pair<std::size_t, T> > >;
+
+/**
+ * Returns the terms of folding a correlator C(t) with num_times time slices,
+ * C_folded(t) = (C(t) + parity * C(num_times - t)) / 2 for t = 0, ..., num_times / 2, where C(num_times) = C(0).
+ */
+template<typename T>
+linear_terms<T> folding_terms(std::size_t num_times, T parity = 1);
+
+/**
+ * Returns the terms of averaging num_correlators equivalent correlators C_e(t) with num_times time slices each,
+ * e.g. over momenta or polarisations, C_average(t) = sum_e C_e((t + shifts[e]) % num_times) / num_correlators.
+ * Input index e * num_times + t refers to C_e(t). shifts may be empty, i.e. all shifts are 0.
+ * Throws if shifts is neither empty nor of size num_correlators.
+ */
+template<typename T>
+linear_terms<T> averaging_terms(std::size_t num_correlators, std::size_t num_times,
+		const std::vector<std::size_t>& shifts = { });
+
+/**
+ * Assigns the linear map terms of the n values at each of the inputs to the n values at each of the outputs.
+ * Outputs must not overlap inputs.
+ */
+template<typename T>
+void apply_linear_terms(const linear_terms<T>& terms, const std::vector<const T*>& inputs, std::size_t n,
+		const std::vector<T*>& outputs);
+
+/**
+ * Folds the raw samples of a correlator, given as one vector of samples per time slice, see folding_terms(...).
+ * Linear, so it can be applied before resampling to reduce the data.
+ * Throws if the time slices have different numbers of samples.
+ */
+template<typename T>
+std::vector<std::vector<T> > fold(const std::vector<std::vector<T> >& correlator, T parity = 1);
+
+/**
+ * Averages the raw samples of equivalent correlators, each given as one vector of samples per time slice, see
+ * averaging_terms(...). Linear, so it can be applied before resampling to reduce the data.
+ * Throws if the correlators have different numbers of time slices or samples.
+ */
+template<typename T>
+std::vector<std::vector<T> > average(const std::vector<std::vector<std::vector<T> > >& correlators,
+		const std::vector<std::size_t>& shifts = { });
+
+}
+}
+}
+}
+
+#include <detail/CorrelatorOperations.tcc>
+
+#endif /* INCLUDE_CORRELATOROPERATIONS_HH_ */
@@ -0,0 +1,79 @@
+#ifndef INCLUDE_COVARIANCEESTIMATE_HH_
+#define INCLUDE_COVARIANCEESTIMATE_HH_
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Jackknife estimate of the covariance matrix of several variables, optionally regularized, together with its
+ * Cholesky factor. The factorization is computed once on construction; all other member functions are const
+ * and can be used concurrently, e.g. for correlated fits in all jackknife bins from several threads.
+ */
+template<typename T>
+class CovarianceEstimate {
+public:
+
+	/**
+	 * Estimates the covariance of N variables from their jackknife samples (N x N_bins, row-major) and means as
+	 * (N_bins - 1) / N_bins * sum_b (x_b - mu_x) (y_b - mu_y).
+	 *
+	 * With shrinkage > 0, the off-diagonal elements are scaled by (1 - shrinkage).
+	 * With svd_cut > 0, eigenvalues of the correlation matrix smaller than svd_cut times the largest eigenvalue
+	 * are raised to that value, which removes poorly determined low modes.
+	 * Throws if the sizes do not match, shrinkage is not in [0, 1] or svd_cut is not in [0, 1).
+	 */
+	CovarianceEstimate(const std::vector<T>& samples, const std::vector<T>& means, T shrinkage = 0, T svd_cut = 0);
+
+	/**
+	 * Returns the number of variables.
+	 */
+	std::size_t size() const;
+
+	/**
+	 * Returns the regularized covariance matrix (row-major).
+	 */
+	const std::vector<T>& matrix() const;
+
+	/**
+	 * Returns the Cholesky factor L of matrix() = L L^T (row-major lower triangle).
+	 */
+	const std::vector<T>& cholesky_factor() const;
+
+	/**
+	 * Assigns L^-1 residuals to whitened, such that chi^2 is the squared norm of whitened.
+	 */
+	void whiten(const T* residuals, T* whitened) const;
+
+	/**
+	 * Returns residuals^T matrix()^-1 residuals.
+	 */
+	T chi2(const T* residuals) const;
+
+	/**
+	 * Assigns matrix()^-1 rhs to solution.
+	 */
+	void solve(const T* rhs, T* solution) const;
+
+private:
+
+	// sums over bins and over the variables are accumulated in at least double precision
+	using accumulator = typename std::common_type<T, double>::type;
+
+	std::size_t N;
+	std::vector<T> covariance;
+	std::vector<T> factor;
+
+};
+
+}
+}
+}
+
+#include <detail/CovarianceEstimate.tcc>
+
+#endif /* INCLUDE_COVARIANCEESTIMATE_HH_ */
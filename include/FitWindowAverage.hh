@@ -0,0 +1,95 @@
+#ifndef INCLUDE_FITWINDOWAVERAGE_HH_
+#define INCLUDE_FITWINDOWAVERAGE_HH_
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+#include <CovarianceEstimate.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Model averaging of linear least-squares fits over all fit windows [t_min, t_max] of a data series.
+ *
+ * The model is given by the values f_j(t) of its basis functions at each data point, y(t) = sum_j p_j f_j(t).
+ * Since the model and the errors do not depend on the data, the whitened model and the normal matrices of all windows
+ * are built from prefix sums and factorized once in the constructor. average(...) then only needs prefix sums of the
+ * whitened data and O(num_parameters^2) operations per window, and can be called concurrently for different data,
+ * e.g. from several threads for different jackknife bins.
+ *
+ * The fit parameters of all windows are averaged with weights exp(-AIC / 2), where
+ * AIC = chi^2 + 2 * num_parameters + 2 * (number of data points outside the window).
+ */
+template<typename T>
+class FitWindowAverage {
+public:
+
+	/**
+	 * Prepare uncorrelated fits of the model (num_points x num_parameters, row-major) in all windows with at least
+	 * min_window_length points, weighting each data point t with 1 / sigmas[t]^2.
+	 * Throws if the sizes do not match, min_window_length does not exceed num_parameters or the model is degenerate
+	 * in a window.
+	 */
+	FitWindowAverage(const std::vector<T>& model, std::size_t num_parameters, const std::vector<T>& sigmas,
+			std::size_t min_window_length);
+
+	/**
+	 * Prepare correlated fits of the model (num_points x num_parameters, row-major) in all windows with at least
+	 * min_window_length points, using the inverse of the corresponding sub-block of covariance as weight matrix.
+	 * The covariance sub-block of each t_min is factorized once; the factor of every window [t_min, t_max] is a
+	 * leading block of it, so all windows with the same t_min share the whitened data.
+	 * Throws if the sizes do not match, min_window_length does not exceed num_parameters or the model is degenerate
+	 * in a window.
+	 */
+	FitWindowAverage(const std::vector<T>& model, std::size_t num_parameters, const CovarianceEstimate<T>& covariance,
+			std::size_t min_window_length);
+
+	/**
+	 * Fits the model to the data y (num_points values) in all windows and assigns the AIC-weighted average of the
+	 * fit parameters to params (num_parameters values).
+	 */
+	void average(const T* y, T* params) const;
+
+	std::size_t num_points() const;
+	std::size_t num_parameters() const;
+	std::size_t num_windows() const;
+
+private:
+
+	// prefix sums are differenced for each window, so they are accumulated in at least double precision
+	using prefix_sum = typename std::common_type<T, double>::type;
+
+	// data points [first, num_points) whitened by a common factor (diagonal if whitening_factor is empty)
+	struct whitening_block {
+		std::size_t first;
+		std::vector<T> whitening_factor;
+		std::vector<T> design; // whitened model, row-major
+	};
+
+	struct window {
+		std::size_t block;
+		std::size_t first, last; // data points [first, last)
+		std::vector<T> cholesky; // normal matrix factor, row-major lower triangle
+	};
+
+	std::size_t N_points;
+	std::size_t N_params;
+	std::vector<T> sigmas;
+	std::vector<whitening_block> blocks;
+	std::vector<window> windows;
+
+	void verify_sizes(const std::vector<T>& model, std::size_t num_points, std::size_t min_window_length) const;
+	void add_windows(std::size_t block, std::size_t first_begin, std::size_t first_end, std::size_t min_window_length);
+
+};
+
+}
+}
+}
+
+#include <detail/FitWindowAverage.tcc>
+
+#endif /* INCLUDE_FITWINDOWAVERAGE_HH_ */
@@ -0,0 +1,41 @@
+#ifndef INCLUDE_FORKEDEVALUATION_HH_
+#define INCLUDE_FORKEDEVALUATION_HH_
+
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Assigns evaluate(i) to results[i] for i < n, with contiguous ranges of i evaluated in num_processes child processes
+ * created by fork(). POSIX only.
+ *
+ * Children see the memory of the calling process copy-on-write, so inputs are not copied, and write their results
+ * into an anonymous shared mapping. evaluate therefore need not be reentrant or thread-safe, e.g. if it wraps code
+ * with global state, but any side effects of evaluate are lost. Children leave with _exit(...) without running
+ * destructors or flushing streams. Evaluates serially in the calling process if num_processes is at most 1 and for
+ * ranges whose child could not be created.
+ * Also evaluates serially if the calling process is multithreaded, see process_is_multithreaded(), e.g. once an
+ * OpenMP parallel region has left its thread pool behind or while a QueryServer runs. A child of a multithreaded
+ * process inherits locks held by the other threads, which do not exist in the child, and may only do
+ * async-signal-safe work, which evaluate typically is not, e.g. because it allocates memory. Fork before starting
+ * threads to benefit from child processes in such programs.
+ * Throws if a child does not finish successfully, e.g. because evaluate throws.
+ */
+template<typename T, typename Evaluate>
+void evaluate_forked(std::size_t n, std::size_t num_processes, Evaluate evaluate, T* results);
+
+/**
+ * Returns whether the calling process has more than one thread, counted in /proc/self/task. Returns false where this
+ * cannot be determined, e.g. on systems without /proc, so there evaluate_forked(...) relies on its caller.
+ */
+bool process_is_multithreaded();
+
+}
+}
+}
+
+#include <detail/ForkedEvaluation.tcc>
+
+#endif /* INCLUDE_FORKEDEVALUATION_HH_ */
@@ -0,0 +1,37 @@
+#ifndef INCLUDE_INDEXSEQUENCE_HH_
+#define INCLUDE_INDEXSEQUENCE_HH_
+
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Compile-time sequence of indices 0, ..., sizeof...(I) - 1, same as std::index_sequence of C++14,
+ * which is not available in C++11.
+ */
+template<std::size_t ... I>
+struct index_sequence {
+};
+
+template<std::size_t N, std::size_t ... I>
+struct make_index_sequence_helper: make_index_sequence_helper<N - 1, N - 1, I...> {
+};
+
+template<std::size_t ... I>
+struct make_index_sequence_helper<0, I...> {
+	using type = index_sequence<I...>;
+};
+
+template<std::size_t N>
+using make_index_sequence = typename make_index_sequence_helper<N>::type;
+
+template<typename ... Ts>
+using index_sequence_for = make_index_sequence<sizeof...(Ts)>;
+
+}
+}
+}
+
+#endif /* INCLUDE_INDEXSEQUENCE_HH_ */
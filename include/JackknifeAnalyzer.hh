@@ -3,15 +3,116 @@
 
 #include <map>
 #include <vector>
+#include <list>
+#include <functional>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <iterator>
+#include <cstddef>
+#include <array>
+#include <utility>
+#include <type_traits>
+
+#include <KeyPrefix.hh>
+#include <IndexSequence.hh>
+#include <SampleStore.hh>
+#include <CovarianceEstimate.hh>
+#include <FitWindowAverage.hh>
+#include <BatchedLevenbergMarquardt.hh>
+#include <RawHistory.hh>
+#include <CorrelatorOperations.hh>
+#include <LinearAlgebra.hh>
+#include <BatchedFFT.hh>
+#include <ForkedEvaluation.hh>
+#include <Reduction.hh>
 
 namespace de_uni_frankfurt_itp {
 namespace reisinger {
 namespace jackknife_analyzer_0219 {
 
-template<typename K, typename T>
+/**
+ * Layout is the layout policy of the jackknife samples in memory, see SampleStore. contiguous_slots stores the
+ * samples of each variable contiguously. slot_tiles<L> interleaves the samples of L variables, which suits analyses
+ * with few bins but many variables: sigmas(...) then computes the errors of L variables at once. All other operations
+ * copy the samples of each variable they read into a contiguous buffer and give the same results for both layouts.
+ */
+template<typename K, typename T, typename Layout = contiguous_slots>
 class JackknifeAnalyzer {
+	using mu_map = std::map<K, T, key_less<K> >;
+
 public:
 
+	/**
+	 * Non-allocating view of a range of keys of a JackknifeAnalyzer in ascending order.
+	 * Invalidated when the variables of the range are removed.
+	 */
+	class key_range {
+	public:
+		class iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = K;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const K*;
+			using reference = const K&;
+
+			iterator() = default;
+			explicit iterator(typename mu_map::const_iterator pos) :
+					pos { pos } {
+			}
+
+			reference operator*() const {
+				return pos->first;
+			}
+			pointer operator->() const {
+				return &pos->first;
+			}
+			iterator& operator++() {
+				++pos;
+				return *this;
+			}
+			iterator operator++(int) {
+				iterator prev = *this;
+				++pos;
+				return prev;
+			}
+			iterator& operator--() {
+				--pos;
+				return *this;
+			}
+			iterator operator--(int) {
+				iterator prev = *this;
+				--pos;
+				return prev;
+			}
+			bool operator==(const iterator& other) const {
+				return pos == other.pos;
+			}
+			bool operator!=(const iterator& other) const {
+				return pos != other.pos;
+			}
+
+		private:
+			typename mu_map::const_iterator pos;
+		};
+
+		key_range(typename mu_map::const_iterator first, typename mu_map::const_iterator last);
+
+		iterator begin() const;
+		iterator end() const;
+		bool empty() const;
+
+		/**
+		 * Returns the number of keys in the range. Linear in the size of the range.
+		 */
+		std::size_t size() const;
+
+	private:
+		typename mu_map::const_iterator first, last;
+	};
+
 	/**
 	 * Create an empty JackknifeAnalyzer with no datasets. Data is stored with arithmetic type T.
 	 * Jackknife-resampled datasets can be added directly or computed from non-resampled datasets or a function.
@@ -21,6 +122,24 @@ public:
 	 */
 	JackknifeAnalyzer(std::size_t bin_size = 1);
 
+	/**
+	 * Copies share the jackknife samples of all variables until either copy modifies the memory holding them
+	 * (copy-on-write). Samples are shared per page of SampleStore::default_page_bytes, so the first change of a
+	 * variable, e.g. adding a variable to a partially filled page, copies the whole page. Raw histories are shared
+	 * until either copy adds or removes one, recorded derivations are immutable and always shared. A copy therefore
+	 * costs the means, the errors and the key index of all variables, i.e. time and memory linear in the number of
+	 * variables, plus the pages and variables it changes afterwards.
+	 * With a memory budget, see set_memory_budget(...), the copy starts with the same order of recently used
+	 * variables as other, but keeps its own order afterwards.
+	 */
+	JackknifeAnalyzer(const JackknifeAnalyzer& other) = default;
+
+	/**
+	 * Replaces the variables, bin size and settings of this JackknifeAnalyzer by those of other, sharing memory
+	 * with other as the copy constructor does.
+	 */
+	JackknifeAnalyzer& operator=(const JackknifeAnalyzer& other) = default;
+
 	/**
 	 * Same as calling
 	 * JackknifeAnalyzer();
@@ -42,6 +161,42 @@ public:
 	 */
 	void resample(const K& Xkey, const std::vector<T>& Xsamples);
 
+	/**
+	 * Same as resample(Xkey, Xsamples), but consumes Xsamples, which is empty afterwards. Without retained raw
+	 * histories, the bins are summed in place in the memory of Xsamples, which is released before returning, so no
+	 * further buffer of the size of the samples is needed. With raw_encoding::exact, the memory of Xsamples is taken
+	 * over by the raw history instead of copied.
+	 */
+	void resample(const K& Xkey, std::vector<T>&& Xsamples);
+
+	/**
+	 * Resamples samples of X from several independent Markov chains (replicas), one vector per replica of any length,
+	 * and stores these and the mean of X under the key Xkey for use in further computations.
+	 * Each replica is divided into bins separately, so no bin contains samples of two replicas. Samples left over at
+	 * the end of a replica only contribute to the mean. The bins of all replicas are jackknifed together, in the order
+	 * of the replicas. rebin(...) merges bins within each replica and reanalyze(...) applies its range to each replica.
+	 * If Xkey already exists, does nothing. Throws if the total number of bins does not match already existing datasets.
+	 */
+	void resample_replicas(const K& Xkey, const std::vector<std::vector<T> >& Xreplicas);
+
+	/**
+	 * Resamples measurements of X on num_sources stochastic sources per configuration, given as
+	 * num_configurations x num_sources values (row-major), and stores jackknife samples and mean of the source
+	 * averages under the key Xkey. Same as averaging over sources per configuration and calling resample(...), but
+	 * the source averages are summed into the bins in the same pass without storing them.
+	 * If Xkey already exists, does nothing. Throws if the number of samples is not a multiple of num_sources or the
+	 * number of bins does not match already existing datasets.
+	 */
+	void resample_sources(const K& Xkey, const std::vector<T>& Xsamples, std::size_t num_sources);
+
+	/**
+	 * Same as resample_sources(Xkey, Xsamples, num_sources), but additionally assigns the jackknife error of the
+	 * mean of X over sources, leaving out one source for all configurations at a time, to sigma_sources.
+	 * Comparing it to sigma(Xkey) shows whether the stochastic noise of the sources dominates.
+	 * sigma_sources is 0 for a single source and is not assigned if Xkey already exists.
+	 */
+	void resample_sources(const K& Xkey, const std::vector<T>& Xsamples, std::size_t num_sources, T& sigma_sources);
+
 	/**
 	 * Computes and stores jackknife samples and mean of a variable F which is a function taking a vector of data type T
 	 * of variables with keys in F_arg_keys.
@@ -66,17 +221,281 @@ public:
 	template<typename Function, typename ... Ks>
 	void add_function(const K& Fkey, Function F, const Ks& ... F_arg_keys);
 
+	/**
+	 * Same as add_function(Fkey, F, F_arg_keys), but F is called as F(args, workspace) with a workspace created by
+	 * make_workspace(), e.g. scratch matrices or fitter state which would otherwise be allocated in every call.
+	 * The bins are evaluated in parallel if OpenMP is enabled; the calling thread reuses the workspace of the mean
+	 * and each other thread creates one workspace for all of its bins, so serial evaluation creates one workspace in
+	 * total.
+	 * Throws if Fkey and one or more keys in F_arg_keys do not exist, or rethrows the first exception thrown by F or
+	 * make_workspace.
+	 */
+	template<typename Function, typename WorkspaceFactory>
+	void add_function_with_workspace(const K& Fkey, Function F, WorkspaceFactory make_workspace,
+			const std::vector<K>& F_arg_keys);
+
+	/**
+	 * Same as add_function(Fkey, F, F_arg_keys), but the bins are evaluated in num_processes child processes, see
+	 * evaluate_forked(...). Gives parallel speedup for functions which cannot be called concurrently from several
+	 * threads, e.g. because they wrap code with global state. The arguments are shared with the children
+	 * copy-on-write and not copied. POSIX only. Evaluates serially in a multithreaded process, see evaluate_forked(...).
+	 * Throws if Fkey and one or more keys in F_arg_keys do not exist, or if F fails in a child process.
+	 */
+	template<typename Function>
+	void add_function_forked(const K& Fkey, Function F, const std::vector<K>& F_arg_keys, std::size_t num_processes);
+
+	/**
+	 * Same as add_function(Fkey, F, F_arg_keys), but Fkey is declared terminal: only the mean, jackknife error and
+	 * jackknife bias of F are stored, the jackknife samples of F are reduced on the fly and never stored.
+	 * A terminal variable cannot be used as argument of further functions and has no samples(...).
+	 */
+	template<typename Function>
+	void add_terminal_function(const K& Fkey, Function F, const std::vector<K>& F_arg_keys);
+
+	/**
+	 * Same as add_function(Fkey, F, F_arg_keys...), but Fkey is declared terminal: only the mean, jackknife error and
+	 * jackknife bias of F are stored, the jackknife samples of F are reduced on the fly and never stored.
+	 * A terminal variable cannot be used as argument of further functions and has no samples(...).
+	 */
+	template<typename Function, typename ... Ks>
+	void add_terminal_function(const K& Fkey, Function F, const Ks& ... F_arg_keys);
+
+	/**
+	 * Fits the linear model y(t) = sum_j p_j * basis[j](t) to the variables with keys y_keys[t] in all fit windows
+	 * [t_min, t_max] with at least min_window_length points, weighting each point with its inverse squared jackknife
+	 * error. For the mean and each jackknife sample, the fit parameters are averaged over all windows with weights
+	 * exp(-AIC / 2), where AIC = chi^2 + 2 * number of parameters + 2 * number of points outside the window,
+	 * and the average of p_j is stored under the key parameter_keys[j]. See FitWindowAverage.
+	 * Parameter keys which already exist are left unchanged. If all parameter keys exist, does nothing.
+	 * Throws if one or more keys in y_keys do not exist, if the number of parameter keys and basis functions differ,
+	 * or if min_window_length does not exceed the number of parameters.
+	 *
+	 * Windows are evaluated with prefix sums shared by all windows, and bins are processed in parallel if OpenMP is
+	 * enabled.
+	 */
+	void add_fit_window_scan(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys,
+			const std::vector<std::function<T(std::size_t)> >& basis, std::size_t min_window_length);
+
+	/**
+	 * Same as add_fit_window_scan(parameter_keys, y_keys, basis, min_window_length), but performs correlated fits
+	 * using the given covariance estimate of the variables y_keys, e.g. from covariance_estimate(y_keys).
+	 * The covariance is kept fixed for all bins, so its sub-blocks are factorized only once.
+	 * Throws if the size of the covariance does not match the number of y_keys.
+	 */
+	void add_fit_window_scan(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys,
+			const std::vector<std::function<T(std::size_t)> >& basis, const CovarianceEstimate<T>& covariance,
+			std::size_t min_window_length);
+
+	/**
+	 * Fits a nonlinear model to the variables with keys y_keys[t] by uncorrelated least squares with weights
+	 * 1 / sigma(y_keys[t])^2 and stores parameter j of the fits to the means and to each jackknife sample under the key
+	 * parameter_keys[j]. See BatchedLevenbergMarquardt for the signature of model.
+	 * The fit to the means starts from initial_parameters, the fits to the jackknife samples start from its result.
+	 * Fits in which a parameter does not affect the model yield NaN parameters.
+	 * Parameter keys which already exist are left unchanged. If all parameter keys exist, does nothing.
+	 * Throws if one or more keys in y_keys do not exist or the numbers of parameter keys and initial parameters differ.
+	 * Rethrows the first exception thrown by model.
+	 *
+	 * Bins are fitted in lockstep batches of W bins, which are processed in parallel if OpenMP is enabled.
+	 * model must then be safe to call concurrently; each thread uses its own copy.
+	 */
+	template<std::size_t W = 8, typename Model>
+	void add_nonlinear_fit(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys, Model model,
+			const std::vector<T>& initial_parameters);
+
+	/**
+	 * Stores the linear combinations sum_k coefficients[o * in_keys.size() + k] * X_k of the variables X_k with keys
+	 * in_keys under the keys out_keys[o], e.g. for projections or changes of basis. coefficients is a
+	 * out_keys.size() x in_keys.size() matrix (row-major). Jackknife samples and means of all outputs are computed
+	 * as one blocked matrix product, see linear_algebra::multiply_rows(...), which is vectorized across bins, also
+	 * for the layout slot_tiles<L>: copying the inputs out of their tiles costs only a fraction 1 / out_keys.size()
+	 * of the product. Output keys which already exist are left unchanged. If all output keys exist, does nothing.
+	 * Throws if one or more keys in in_keys do not exist or the size of coefficients does not match.
+	 */
+	void add_linear_combinations(const std::vector<K>& out_keys, const std::vector<T>& coefficients,
+			const std::vector<K>& in_keys);
+
+	/**
+	 * Fourier transforms the array-valued variable with real parts re_in_keys[x] and imaginary parts im_in_keys[x]
+	 * over the points x of a lattice with the given extents (numbered row-major), e.g. to project a position-space
+	 * correlator to momenta, and stores real and imaginary parts of the transform at momentum k under the keys
+	 * re_out_keys[k] and im_out_keys[k], see BatchedFFT for the convention. im_in_keys may be empty for real input.
+	 * All bins and the means are transformed in one batch. Output keys which already exist are left unchanged. If
+	 * all output keys exist, does nothing.
+	 * Throws if one or more input keys do not exist or the numbers of keys do not match the number of points.
+	 */
+	void add_fourier_transform(const std::vector<K>& re_out_keys, const std::vector<K>& im_out_keys,
+			const std::vector<K>& re_in_keys, const std::vector<K>& im_in_keys, const std::vector<std::size_t>& extents,
+			int sign = -1);
+
+	/**
+	 * Folds the correlator with time slices correlator_keys[t] and stores
+	 * (C(t) + parity * C(T - t)) / 2 for t = 0, ..., T / 2 under the keys folded_keys[t], see correlator::fold(...).
+	 * All time slices and bins are processed in one pass. Folded keys which already exist are left unchanged. If all
+	 * folded keys exist, does nothing.
+	 * Throws if one or more keys in correlator_keys do not exist or if folded_keys does not have T / 2 + 1 keys.
+	 */
+	void add_folded_correlator(const std::vector<K>& folded_keys, const std::vector<K>& correlator_keys, T parity = 1);
+
+	/**
+	 * Averages equivalent correlators, e.g. over momenta or polarisations, where correlator_keys[e][t] is time slice
+	 * t of correlator e, and stores the average over e of C_e((t + shifts[e]) % T) under the key average_keys[t],
+	 * see correlator::average(...). shifts may be empty. Average keys which already exist are left unchanged. If all
+	 * average keys exist, does nothing.
+	 * Throws if one or more keys in correlator_keys do not exist, or if the correlators, average_keys and shifts
+	 * differ in size.
+	 */
+	void add_averaged_correlator(const std::vector<K>& average_keys,
+			const std::vector<std::vector<K> >& correlator_keys, const std::vector<std::size_t>& shifts = { });
+
 	/**
 	 * Removes the variable with key Xkey from the JackknifeAnalyzer.
 	 * Does nothing if Xkey does not exist.
 	 */
 	void remove(const K& Xkey);
 
+	/**
+	 * Moves the jackknife samples of all variables into contiguous storage, filling the holes left by removed
+	 * variables, and releases storage which is no longer needed.
+	 * Otherwise, storage shared by removed and remaining variables is only recycled for new variables, while storage
+	 * of removed variables only is returned immediately. With a memory budget, see set_memory_budget(...),
+	 * compacting happens automatically once at least half of the storage is unused.
+	 */
+	void compact();
+
+	/**
+	 * Returns a new JackknifeAnalyzer with factor times the bin size, without access to the original data.
+	 * For variables added with resample(...), the bin averages are reconstructed from the jackknife samples and the
+	 * mean, adjacent bins are merged and the jackknife samples are recomputed. Bins left over at the end are dropped,
+	 * exactly as if the data was resampled with the new bin size.
+	 * All other variables are re-evaluated from their recorded derivations, e.g. the function passed to add_function(...),
+	 * in the order in which they were added. Derivations of removed variables are replayed as well if other variables
+	 * depend on them. The new JackknifeAnalyzer keeps the memory budget and the scratch file, see set_memory_budget(...).
+	 * Throws if a variable cannot be reconstructed, e.g. because it was added with add_resampled(...) or depends on a
+	 * removed variable added with resample(...), or if less than 2 bins remain.
+	 */
+	JackknifeAnalyzer rebin(std::size_t factor) const;
+
+	/**
+	 * If retain is true, the raw samples passed to resample(...) or resample_replicas(...) afterwards are kept in
+	 * memory with the given encoding, which allows reanalyze(...) with different bin sizes or cuts. Off by default.
+	 */
+	void retain_raw_histories(bool retain, raw_encoding encoding = raw_encoding::exact);
+
+	/**
+	 * Sets the summation order of the sums over bins and samples, i.e. of errors, biases, covariances and means.
+	 * reduction_mode::sequential (the default) sums in a single thread in the order of a plain loop, and resample(...)
+	 * subtracts the samples of each bin one by one from the sum of all samples.
+	 * reduction_mode::reproducible sums more than reduction::block_size bins or samples in parallel, with results
+	 * which do not depend on the number of threads but may differ from sequential sums in the last bits.
+	 * reduction_mode::fast also saves the fixed combination of the block sums. rebin(...) and reanalyze(...) keep the
+	 * mode.
+	 */
+	void set_reduction_mode(reduction_mode mode);
+
+	/**
+	 * Returns the decoded raw samples of the variable with key Xkey.
+	 * Throws if no raw history of Xkey was retained.
+	 */
+	std::vector<T> raw_history(const K& Xkey) const;
+
+	/**
+	 * If the raw history of the variable with key Xkey was retained, assigns the mean / jackknife error of Xkey
+	 * restricted to the bins [first_bin, last_bin), i.e. to the samples [first_bin * bin_size, last_bin * bin_size),
+	 * to mu_X / sigma_X and returns true. Otherwise does nothing and returns false.
+	 * Uses prefix sums of the bin sums and their squares, so the cost is independent of the number of bins and no
+	 * raw samples are decoded, e.g. to scan many thermalization cuts or sub-ensembles.
+	 * Throws if the range contains less than 2 bins or exceeds the number of bins.
+	 */
+	bool jackknife_range(const K& Xkey, std::size_t first_bin, std::size_t last_bin, T& mu_X, T& sigma_X) const;
+
+	/**
+	 * Returns a new JackknifeAnalyzer in which all variables added with resample(...) are resampled again from their
+	 * retained raw samples [first, last) with bin size new_bin_size, and all other variables are re-evaluated from
+	 * their recorded derivations as in rebin(...). The new JackknifeAnalyzer retains the cut raw histories and keeps the
+	 * memory budget and the scratch file.
+	 * Throws if a variable added with resample(...) has no raw history, if the range is empty or contains less than
+	 * 2 bins, or if a variable cannot be reconstructed, see rebin(...).
+	 */
+	JackknifeAnalyzer reanalyze(std::size_t new_bin_size, std::size_t first = 0,
+			std::size_t last = static_cast<std::size_t>(-1)) const;
+
+	/**
+	 * Returns a copy of the JackknifeAnalyzer which shares the jackknife samples, raw histories and recorded
+	 * derivations with this one, see the copy constructor for its cost. Useful to try variants of an analysis
+	 * without duplicating the samples of existing variables.
+	 * A snapshot shares the scratch file of set_memory_budget(...), whose accesses are serialized, but keeps its own
+	 * order of recently used variables, so the snapshot may spill and page in concurrently with the original. Const
+	 * member functions read spilled samples from the scratch file without paging them in, so a snapshot of an
+	 * analyzer with a memory budget can be queried, e.g. by a QueryServer, while the original keeps changing.
+	 */
+	JackknifeAnalyzer snapshot() const;
+
+	/**
+	 * Returns false if a NaN or infinite value was found in the jackknife samples or the mean of the variable with
+	 * key Xkey when it was stored. Every variable is checked by a vectorized pass when it is added, so a bad
+	 * configuration or a failing per-bin computation is detected where it first occurs.
+	 * Returns true if Xkey does not exist.
+	 */
+	bool is_valid(const K& Xkey) const;
+
+	/**
+	 * Returns the indices of the bins in which NaN or infinite values were found for the variable with key Xkey.
+	 * For variables added with resample(...) and similar, these are the bins of the input containing such values,
+	 * since they spoil all jackknife samples. Empty if Xkey is valid or does not exist, and for invalid variables
+	 * without invalid bins, e.g. terminal variables or variables whose mean is invalid.
+	 */
+	std::vector<std::size_t> invalid_bins(const K& Xkey) const;
+
+	/**
+	 * Returns the keys of all variables which are not valid, see is_valid(...).
+	 */
+	std::vector<K> invalid_keys() const;
+
+	/**
+	 * Returns the number of bins, i.e. of jackknife samples per variable, or 0 if no variable was added yet.
+	 */
+	std::size_t num_bins() const;
+
+	/**
+	 * Returns true if the variable with key Xkey was added with add_terminal_function(...), i.e. only its mean,
+	 * jackknife error and bias are stored. Returns false if Xkey does not exist.
+	 */
+	bool is_terminal(const K& Xkey) const;
+
 	/**
 	 * Returns a vector of keys of all variables in the JackknifeAnalyzer.
 	 */
 	std::vector<K> keys() const;
 
+	/**
+	 * Returns a view of the keys of all variables in the JackknifeAnalyzer without copying them.
+	 */
+	key_range key_view() const;
+
+	/**
+	 * Returns a view of all keys in [first, last).
+	 */
+	key_range key_view(const K& first, const K& last) const;
+
+	/**
+	 * Returns a view of all keys starting with prefix. Logarithmic in the number of variables. In C++11, which lacks
+	 * heterogeneous lookup in std::map, the lookup starts at the smallest key with prefix and is linear for tuple keys
+	 * whose components after the prefix are neither arithmetic nor strings, see smallest_key_with_prefix.
+	 * For string keys, prefix is a string or character array, e.g. "pion/" selects "pion/t0", "pion/t1", ...
+	 * For std::tuple keys, prefix is a std::tuple of the leading components, e.g. std::make_tuple(channel) selects
+	 * all keys with first component channel.
+	 */
+	template<typename P>
+	key_range keys_with_prefix(const P& prefix) const;
+
+	/**
+	 * Returns the string keys matching the wildcard pattern, where '*' matches any sequence of characters and
+	 * '?' matches a single character. Only keys starting with the literal part of the pattern before the first
+	 * wildcard are examined, each in at most pattern.size() * key.size() steps.
+	 */
+	std::vector<K> keys_matching(const K& pattern) const;
+
 	/**
 	 * Returns the mean of the variable with key Xkey.
 	 * Throws if Xkey does not exist.
@@ -89,6 +508,14 @@ public:
 	 */
 	T sigma(const K& Xkey) const;
 
+	/**
+	 * Returns the jackknife errors of the variables with keys Xkeys, same as sigma(...) for each key.
+	 * With the layout slot_tiles<L>, the errors of all variables stored in the same tile are computed at once,
+	 * vectorized across the variables.
+	 * Throws if one or more keys in Xkeys do not exist.
+	 */
+	std::vector<T> sigmas(const std::vector<K>& Xkeys) const;
+
 	/**
 	 * If a key Xkey does not exist, does nothing and returns false, otherwise
 	 * assigns the mean / jackknife error of the variable with key Xkey to mu_X / sigma_X and returns true.
@@ -96,20 +523,178 @@ public:
 	bool jackknife(const K& Xkey, T& mu_X, T& sigma_X) const;
 
 	/**
-	 * Returns a copy of the jackknife samples of the variable with key Xkey.
+	 * Returns the jackknife estimate of the bias of the mean of the variable with key Xkey, i.e.
+	 * (N_bins - 1) * (average of jackknife samples - mean).
 	 * Throws if Xkey does not exist.
 	 */
+	T bias(const K& Xkey) const;
+
+	/**
+	 * Returns the jackknife estimate of the covariance of the variables with keys Xkey and Ykey.
+	 * Throws if Xkey or Ykey do not exist or are terminal.
+	 */
+	T covariance(const K& Xkey, const K& Ykey) const;
+
+	/**
+	 * Returns the jackknife estimate of the covariance matrix of the variables with keys Xkeys, regularized with
+	 * shrinkage and svd_cut and factorized once, see CovarianceEstimate. The estimate is independent of the
+	 * JackknifeAnalyzer and can be shared read-only, e.g. captured by reference in functions passed to add_function(...).
+	 * Throws if one or more keys do not exist or are terminal.
+	 */
+	CovarianceEstimate<T> covariance_estimate(const std::vector<K>& Xkeys, T shrinkage = 0, T svd_cut = 0) const;
+
+	/**
+	 * Returns a copy of the jackknife samples of the variable with key Xkey.
+	 * Throws if Xkey does not exist or is terminal.
+	 */
 	std::vector<T> samples(const K& Xkey) const;
 
+	/**
+	 * Limits the memory used by resident jackknife samples to approximately max_bytes.
+	 * If the budget is exceeded, the samples of the least recently used variables are written to the scratch file
+	 * scratch_path and read back transparently when they are accessed again. Means and jackknife errors of spilled
+	 * variables stay in memory. A budget of 0 disables spilling.
+	 * Reading samples through the const member functions also marks the variable as recently used. Const member
+	 * functions may be called concurrently, also while they read spilled samples.
+	 * The space of removed variables in the scratch file is reused by later spills. Analyzers returned by rebin(...)
+	 * and reanalyze(...) keep the budget and share the scratch file.
+	 * Throws if the scratch file cannot be opened, or if a scratch file with a different path is already in use.
+	 * The scratch file is deleted when no JackknifeAnalyzer uses it anymore.
+	 */
+	void set_memory_budget(std::size_t max_bytes, const std::string& scratch_path);
+
 private:
 
 	std::size_t N_bins;
-	const std::size_t bin_size;
+	std::size_t bin_size;
 	void init();
 	bool init_or_verify_N(const std::vector<T>& Xsamples, bool binned);
 
-	std::map<K, std::vector<T> > Xs_reduced_samples;
-	std::map<K, T> Xs_mu;
+	mu_map Xs_mu;
+	std::map<K, std::size_t> Xs_num_samples;
+	bool retain_raw;
+	raw_encoding raw_retention_encoding;
+	using raw_map = std::map<K, std::shared_ptr<const RawHistory<T> > >;
+	std::shared_ptr<raw_map> Xs_raw; // shared by copies until either changes it, see unshared(...)
+
+	// prefix sums are differenced for each range, so they are accumulated in at least double precision
+	using prefix_sum = typename std::common_type<T, double>::type;
+	struct bin_prefix_sums {
+		prefix_sum shift;
+		std::vector<prefix_sum> sums, squares; // of bin sums - shift, over bins [0, b)
+	};
+	std::map<K, std::shared_ptr<const bin_prefix_sums> > Xs_bin_prefix_sums;
+	std::map<K, std::vector<std::size_t> > Xs_replica_lengths; // of variables added with resample_replicas(...)
+	std::map<K, std::vector<std::size_t> > Xs_invalid_bins; // of variables with NaN or infinite values
+	// A derivation is kept alive by the variables it derived last and by the derivations using them as arguments,
+	// so derivations which are no longer needed by rebin(...) are freed as soon as their variables are removed.
+	struct derivation {
+		std::vector<K> outputs;
+		std::vector<std::shared_ptr<const derivation> > dependencies; // of the derived arguments, when recorded
+		std::size_t sequence; // replayed in the order of recording
+		std::function<void(JackknifeAnalyzer&)> derive;
+
+		derivation(const std::vector<K>& outputs, std::vector<std::shared_ptr<const derivation> > dependencies,
+				std::size_t sequence, std::function<void(JackknifeAnalyzer&)> derive);
+		~derivation();
+	};
+	std::map<K, std::shared_ptr<const derivation> > Xs_derivation; // latest derivation of each derived variable
+	std::size_t num_recorded_derivations;
+	std::map<K, std::size_t> Xs_slot;
+	SampleStore<T, Layout> sample_store;
+
+	std::size_t memory_budget;
+	reduction_mode reductions;
+	// scratch file of set_memory_budget(...), shared by copies and by rebinned and reanalyzed analyzers
+	struct scratch_space {
+		std::string path;
+		std::fstream file;
+		std::mutex mutex; // guards file and free_extents
+		std::map<std::size_t, std::vector<std::streamoff> > free_extents; // offsets of released extents by their bytes
+
+		explicit scratch_space(const std::string& path);
+		~scratch_space();
+	};
+	// Samples of a spilled variable in the scratch file. The extent is released for reuse by later spills as soon as
+	// no copy of the analyzer refers to it anymore.
+	struct spilled_extent {
+		std::shared_ptr<scratch_space> scratch;
+		std::streamoff offset;
+		std::size_t bytes;
+
+		spilled_extent(std::shared_ptr<scratch_space> scratch, std::streamoff offset, std::size_t bytes);
+		~spilled_extent();
+	};
+	std::shared_ptr<scratch_space> scratch;
+	std::map<K, std::shared_ptr<const spilled_extent> > spilled_extents;
+	std::map<K, T> Xs_sigma;
+	std::map<K, T> Xs_bias;
+
+	/**
+	 * Resident variables in the order of their last use, most recent first. Copies refer to their own list.
+	 * Guarded by its own mutex, since const member functions use variables concurrently.
+	 */
+	class lru_order {
+	public:
+		lru_order() = default;
+		lru_order(const lru_order& other);
+		lru_order& operator=(const lru_order& other);
+
+		void touch(const K& Xkey);
+		void erase(const K& Xkey);
+		void clear();
+		bool contains(const K& Xkey) const;
+		std::size_t size() const;
+		K least_recent() const;
+
+	private:
+		std::list<K> keys;
+		std::map<K, typename std::list<K>::iterator> positions;
+		mutable std::mutex mutex;
+	};
+	mutable lru_order lru;
+
+	void add_bin_sums(const K& Xkey, const std::vector<T>& bin_sums, const T& sum_samples, std::size_t num_samples);
+	void add_reduced_sums(const K& Xkey, const std::vector<T>& bin_sums, const std::vector<T>& reduced_sums,
+			const T& sum_samples, std::size_t num_samples);
+	T sum_into_bins(const T* samples, std::size_t num_samples, T* bin_sums, T* reduced_sums) const;
+	void store_bin_prefix_sums(const K& Xkey, const std::vector<T>& bin_sums, const T& sum_samples,
+			std::size_t num_samples);
+	void rederive(JackknifeAnalyzer& target) const;
+	void record_derivation(const std::vector<K>& Xkeys, const std::vector<K>& new_Xkeys, const std::vector<K>& arg_keys,
+			std::function<void(JackknifeAnalyzer&)> derive);
+	bool is_derived_by(const K& Xkey, const derivation* recorded) const;
+	template<typename U>
+	static U& unshared(std::shared_ptr<U>& shared);
+	std::vector<K> new_keys(const std::vector<K>& Xkeys) const;
+	bool is_spilled(const K& Xkey) const;
+	void store_summary(const K& Fkey, const T& F_mu, const T& sum_deviations, const double& sum_squared_deviations);
+	template<typename Deviation>
+	void store_summary(const K& Fkey, const T& F_mu, Deviation deviation);
+	static bool all_finite(const T* values, std::size_t n);
+	void validate(const K& Xkey, const T* Xjackknife_samples, const T& mu_X);
+	void page_in(const K& Xkey);
+	using gather_buffer = std::list<std::vector<T> >; // contiguous copies of samples, stable addresses
+	const T* resident_samples(const K& Xkey, gather_buffer& gathered) const;
+	std::vector<T> read_spilled(const K& Xkey) const;
+	void read_spilled(const K& Xkey, T* Xjackknife_samples) const;
+	template<typename Fill>
+	void store_samples(const K& Xkey, const T& mu_X, Fill fill_samples);
+	template<typename Fill>
+	void store_samples(const std::vector<K>& Xkeys, Fill fill_samples);
+	void add_fit_window_scan(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys,
+			const FitWindowAverage<T>& windows);
+	void add_linear_terms(const std::vector<K>& out_keys, const correlator::linear_terms<T>& terms,
+			const std::vector<K>& in_keys);
+	static std::vector<T> basis_values(const std::vector<std::function<T(std::size_t)> >& basis,
+			std::size_t num_points);
+	template<typename Function, std::size_t ... I>
+	static T call_on_bin(Function& F, const std::array<const T*, sizeof...(I)>& args_samples, std::size_t i,
+			index_sequence<I...>);
+	void touch(const K& Xkey) const;
+	void spill(const K& Xkey);
+	void enforce_memory_budget();
+	T jackknife_sigma(const T* Xjackknife_samples, const T& mu_X) const;
 
 };
 
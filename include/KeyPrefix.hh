@@ -0,0 +1,212 @@
+#ifndef INCLUDE_KEYPREFIX_HH_
+#define INCLUDE_KEYPREFIX_HH_
+
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+#include <IndexSequence.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Compares the first prefix.size() characters of key with prefix.
+ * Returns a negative value, 0 or a positive value if the leading part of key is lexicographically smaller than,
+ * equal to or greater than prefix.
+ */
+template<typename C, typename Tr, typename A>
+int compare_prefix(const std::basic_string<C, Tr, A>& key, const std::basic_string<C, Tr, A>& prefix) {
+	return key.compare(0, prefix.size(), prefix);
+}
+
+template<typename C, typename Tr, typename A>
+int compare_prefix(const std::basic_string<C, Tr, A>& key, const C* prefix) {
+	return key.compare(0, Tr::length(prefix), prefix);
+}
+
+template<std::size_t I, typename ... Ks, typename ... Ps>
+typename std::enable_if<I == sizeof...(Ps), int>::type compare_tuple_prefix(const std::tuple<Ks...>&,
+		const std::tuple<Ps...>&) {
+	return 0;
+}
+
+template<std::size_t I, typename ... Ks, typename ... Ps>
+typename std::enable_if<I < sizeof...(Ps), int>::type compare_tuple_prefix(const std::tuple<Ks...>& key,
+		const std::tuple<Ps...>& prefix) {
+	if (std::get<I>(key) < std::get<I>(prefix))
+		return -1;
+	if (std::get<I>(prefix) < std::get<I>(key))
+		return 1;
+	return compare_tuple_prefix<I + 1>(key, prefix);
+}
+
+/**
+ * Compares the first sizeof...(Ps) components of a tuple key with the tuple prefix.
+ * Returns a negative value, 0 or a positive value if the leading components of key are lexicographically smaller than,
+ * equal to or greater than prefix.
+ */
+template<typename ... Ks, typename ... Ps>
+int compare_prefix(const std::tuple<Ks...>& key, const std::tuple<Ps...>& prefix) {
+	static_assert(sizeof...(Ps) <= sizeof...(Ks), "key prefix has more components than the key");
+	return compare_tuple_prefix<0>(key, prefix);
+}
+
+/**
+ * Smallest value of a key component type, if it has one: negative infinity or the lowest value of arithmetic types,
+ * and the empty string.
+ */
+template<typename T, typename Enable = void>
+struct smallest_value {
+	static constexpr bool exists = false;
+};
+
+template<typename T>
+struct smallest_value<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+	static constexpr bool exists = true;
+
+	static T get() {
+		return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+	}
+};
+
+template<typename C, typename Tr, typename A>
+struct smallest_value<std::basic_string<C, Tr, A> > {
+	static constexpr bool exists = true;
+
+	static std::basic_string<C, Tr, A> get() {
+		return { };
+	}
+};
+
+/**
+ * Smallest key of type K starting with a prefix of type P, if it can be constructed: the prefix itself for string
+ * keys, and the prefix completed by the smallest values of the remaining components for tuple keys.
+ */
+template<typename K, typename P>
+struct smallest_key_with_prefix {
+	static constexpr bool exists = false;
+};
+
+template<typename C, typename Tr, typename A, typename P>
+struct smallest_key_with_prefix<std::basic_string<C, Tr, A>, P> {
+	static constexpr bool exists = true;
+
+	static std::basic_string<C, Tr, A> get(const P& prefix) {
+		return prefix;
+	}
+};
+
+template<typename ... Ks>
+struct all_smallest_values_exist;
+
+template<>
+struct all_smallest_values_exist<> {
+	static constexpr bool value = true;
+};
+
+template<typename K0, typename ... Ks>
+struct all_smallest_values_exist<K0, Ks...> {
+	static constexpr bool value = smallest_value<K0>::exists && all_smallest_values_exist<Ks...>::value;
+};
+
+template<typename ... Ks>
+struct remaining_smallest_values_exist;
+
+template<typename ... Ks>
+struct remaining_smallest_values_exist<std::tuple<Ks...>, std::tuple<> > {
+	static constexpr bool value = all_smallest_values_exist<Ks...>::value;
+};
+
+template<typename K0, typename ... Ks, typename P0, typename ... Ps>
+struct remaining_smallest_values_exist<std::tuple<K0, Ks...>, std::tuple<P0, Ps...> > {
+	static constexpr bool value = remaining_smallest_values_exist<std::tuple<Ks...>, std::tuple<Ps...> >::value;
+};
+
+template<typename ... Ks, typename ... Ps>
+struct smallest_key_with_prefix<std::tuple<Ks...>, std::tuple<Ps...> > {
+	static_assert(sizeof...(Ps) <= sizeof...(Ks), "key prefix has more components than the key");
+	static constexpr bool exists = remaining_smallest_values_exist<std::tuple<Ks...>, std::tuple<Ps...> >::value;
+
+	static std::tuple<Ks...> get(const std::tuple<Ps...>& prefix) {
+		return get(prefix, index_sequence_for<Ks...> { });
+	}
+
+private:
+
+	template<std::size_t ... I>
+	static std::tuple<Ks...> get(const std::tuple<Ps...>& prefix, index_sequence<I...>) {
+		return std::tuple<Ks...>(component<I>(prefix)...);
+	}
+
+	template<std::size_t I>
+	static typename std::enable_if<I < sizeof...(Ps), typename std::tuple_element<I, std::tuple<Ks...> >::type>::type component(
+			const std::tuple<Ps...>& prefix) {
+		return std::get<I>(prefix);
+	}
+
+	template<std::size_t I>
+	static typename std::enable_if<I >= sizeof...(Ps), typename std::tuple_element<I, std::tuple<Ks...> >::type>::type component(
+			const std::tuple<Ps...>&) {
+		return smallest_value<typename std::tuple_element<I, std::tuple<Ks...> >::type>::get();
+	}
+};
+
+/**
+ * Returns the first element of the ordered map whose key starts with prefix or is greater than all keys starting with
+ * prefix, without heterogeneous lookup. Logarithmic in the size of map if the smallest key with prefix can be
+ * constructed, see smallest_key_with_prefix, and linear otherwise.
+ */
+template<typename Map, typename P>
+typename std::enable_if<smallest_key_with_prefix<typename Map::key_type, P>::exists, typename Map::const_iterator>::type prefix_lower_bound(
+		const Map& map, const P& prefix) {
+	return map.lower_bound(smallest_key_with_prefix<typename Map::key_type, P>::get(prefix));
+}
+
+template<typename Map, typename P>
+typename std::enable_if<!smallest_key_with_prefix<typename Map::key_type, P>::exists, typename Map::const_iterator>::type prefix_lower_bound(
+		const Map& map, const P& prefix) {
+	return std::find_if(map.begin(), map.end(), [&prefix](const typename Map::value_type& key_value) {
+		return compare_prefix(key_value.first, prefix) >= 0;
+	});
+}
+
+/**
+ * Lookup probe matching all keys whose leading part compares equal to prefix according to compare_prefix(...).
+ */
+template<typename P>
+struct key_prefix {
+	const P& prefix;
+};
+
+/**
+ * Ordering of keys K by operator<, which additionally allows heterogeneous lookup of key_prefix probes
+ * in ordered containers. Keys with a common prefix form a contiguous range in this ordering.
+ */
+template<typename K>
+struct key_less {
+	using is_transparent = void;
+
+	bool operator()(const K& lhs, const K& rhs) const {
+		return lhs < rhs;
+	}
+
+	template<typename P>
+	bool operator()(const K& key, const key_prefix<P>& probe) const {
+		return compare_prefix(key, probe.prefix) < 0;
+	}
+
+	template<typename P>
+	bool operator()(const key_prefix<P>& probe, const K& key) const {
+		return compare_prefix(key, probe.prefix) > 0;
+	}
+};
+
+}
+}
+}
+
+#endif /* INCLUDE_KEYPREFIX_HH_ */
@@ -0,0 +1,56 @@
+#ifndef INCLUDE_LINEARALGEBRA_HH_
+#define INCLUDE_LINEARALGEBRA_HH_
+
+#include <vector>
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+namespace linear_algebra {
+
+/**
+ * Replaces the lower triangle of the symmetric positive definite n x n matrix (row-major) by its Cholesky factor L
+ * with matrix = L L^T. The upper triangle is not referenced.
+ * Throws if the matrix is not positive definite.
+ */
+template<typename T>
+void cholesky_decompose(T* matrix, std::size_t n);
+
+/**
+ * Overwrites rhs with L^-1 rhs for the Cholesky factor L (n x n, row-major lower triangle).
+ */
+template<typename T>
+void forward_substitute(const T* factor, std::size_t n, T* rhs);
+
+/**
+ * Overwrites rhs with (L L^T)^-1 rhs for the Cholesky factor L (n x n, row-major lower triangle).
+ */
+template<typename T>
+void cholesky_solve(const T* factor, std::size_t n, T* rhs);
+
+/**
+ * Computes eigenvalues and eigenvectors of the symmetric n x n matrix (row-major) with the cyclic Jacobi method.
+ * Column i of eigenvectors (row-major) is the normalized eigenvector of eigenvalues[i].
+ */
+template<typename T>
+void symmetric_eigensystem(const std::vector<T>& matrix, std::size_t n, std::vector<T>& eigenvalues,
+		std::vector<T>& eigenvectors);
+
+/**
+ * Assigns outputs[o][i] = sum_k matrix[o * inputs.size() + k] * inputs[k][i] for i < n, i.e. the product of the
+ * outputs.size() x inputs.size() matrix (row-major) with the matrix whose rows are the n values at each input.
+ * The product is blocked over values and inputs to reuse cached rows, and the value blocks are processed in parallel
+ * if OpenMP is enabled. Zero matrix elements are skipped. Outputs must not overlap inputs.
+ */
+template<typename T>
+void multiply_rows(const T* matrix, const std::vector<const T*>& inputs, std::size_t n, const std::vector<T*>& outputs);
+
+}
+}
+}
+}
+
+#include <detail/LinearAlgebra.tcc>
+
+#endif /* INCLUDE_LINEARALGEBRA_HH_ */
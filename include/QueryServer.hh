@@ -0,0 +1,104 @@
+#ifndef INCLUDE_QUERYSERVER_HH_
+#define INCLUDE_QUERYSERVER_HH_
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+
+#include <JackknifeAnalyzer.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Serves read-only queries against snapshots of a JackknifeAnalyzer on a Unix domain socket from a background
+ * thread, e.g. for plotting tools or dashboards during long ingestion runs. POSIX only; requires linking with the
+ * thread library.
+ *
+ * The writer calls publish(...) whenever the state should become visible. This takes a snapshot, which shares the
+ * jackknife samples, raw histories and recorded derivations with the analyzer (see JackknifeAnalyzer::snapshot()),
+ * so it copies the means, errors and key index, in time linear in the number of variables. Afterwards, the first
+ * change of a page of samples shared with a published snapshot copies that page. The serving thread may drop the last
+ * reference to an older snapshot at any time; the writer then changes its pages in place, ordered after the queries on
+ * them by an acquire fence, see SampleStore. All queries are answered from the most recently published snapshot and
+ * are therefore consistent with each other.
+ * The analyzer may use a memory budget while it is published: the snapshot shares the scratch file of
+ * JackknifeAnalyzer::set_memory_budget(...), whose accesses are serialized, and queries read spilled samples from it
+ * without paging them in.
+ *
+ * All connected clients are served by the background thread, one request at a time, so a client which keeps its
+ * connection open without sending requests does not block others. A client which does not accept a response within
+ * send_timeout_ms or sends a request longer than max_request_bytes is disconnected. Each request is one line of
+ * tab-separated fields, keys are given by the names returned by key_name. Each response is one line starting with
+ * "ok" or "error", followed by tab-separated values:
+ *   keys                  -> ok <name> <name> ...
+ *   mu <name>             -> ok <mean>
+ *   sigma <name>          -> ok <jackknife error>
+ *   samples <name>        -> ok <sample> <sample> ...
+ *   cov <name> <name>     -> ok <covariance>
+ */
+template<typename K, typename T, typename Layout = contiguous_slots>
+class QueryServer {
+public:
+
+	static constexpr int send_timeout_ms = 1000;
+	static constexpr std::size_t max_request_bytes = 1 << 16;
+
+	/**
+	 * Starts serving on a new socket at socket_path, which is removed when the QueryServer is destroyed.
+	 * Queries fail until the first publish(...). key_name must map different keys to different names without tabs
+	 * or line breaks.
+	 * Throws if the socket cannot be created.
+	 */
+	QueryServer(const std::string& socket_path, std::function<std::string(const K&)> key_name);
+
+	/**
+	 * Stops serving after the current request, closes all connections and removes the socket.
+	 */
+	~QueryServer();
+
+	QueryServer(const QueryServer&) = delete;
+	QueryServer& operator=(const QueryServer&) = delete;
+
+	/**
+	 * Publishes a snapshot of analyzer, on which subsequent queries are answered.
+	 */
+	void publish(const JackknifeAnalyzer<K, T, Layout>& analyzer);
+
+private:
+
+	struct published_state {
+		JackknifeAnalyzer<K, T, Layout> analyzer;
+		std::map<std::string, K> keys; // by name, built by the serving thread
+	};
+
+	std::string socket_path;
+	std::function<std::string(const K&)> key_name;
+	int listen_fd;
+
+	std::mutex published_mutex;
+	std::shared_ptr<published_state> published;
+
+	std::atomic<bool> stopping;
+	std::thread server;
+
+	void serve();
+	bool serve_client(int client_fd, std::string& buffer);
+	std::string answer(const std::string& request);
+
+};
+
+}
+}
+}
+
+#include <detail/QueryServer.tcc>
+
+#endif /* INCLUDE_QUERYSERVER_HH_ */
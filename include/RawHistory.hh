@@ -0,0 +1,95 @@
+#ifndef INCLUDE_RAWHISTORY_HH_
+#define INCLUDE_RAWHISTORY_HH_
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Storage formats of RawHistory.
+ * exact: values of type T, lossless.
+ * single_precision: values rounded to float.
+ * shared_exponent_32 / shared_exponent_16: blocks of RawHistory::block_size values share one binary exponent and store
+ * 32 / 16 bit integer mantissas, i.e. a relative precision of 2^-31 / 2^-15 of the largest finite magnitude in the
+ * block. NaN and infinite values are stored exactly.
+ */
+enum class raw_encoding {
+	exact, single_precision, shared_exponent_32, shared_exponent_16
+};
+
+/**
+ * Compactly encoded time series of raw (non-resampled) measurements of arithmetic type T.
+ */
+template<typename T>
+class RawHistory {
+public:
+
+	static constexpr std::size_t block_size = 64;
+
+	/**
+	 * Encodes samples with the given encoding.
+	 */
+	RawHistory(const std::vector<T>& samples, raw_encoding encoding = raw_encoding::exact);
+
+	/**
+	 * Encodes samples with the given encoding. With raw_encoding::exact, the memory of samples is taken over
+	 * instead of copied.
+	 */
+	RawHistory(std::vector<T>&& samples, raw_encoding encoding = raw_encoding::exact);
+
+	/**
+	 * Returns the number of encoded samples.
+	 */
+	std::size_t size() const;
+
+	raw_encoding encoding() const;
+
+	/**
+	 * Returns the number of bytes used to store the encoded samples.
+	 */
+	std::size_t memory() const;
+
+	/**
+	 * Returns all decoded samples.
+	 */
+	std::vector<T> decode() const;
+
+	/**
+	 * Assigns the decoded samples [first, last) to decoded.
+	 * Throws if the range exceeds the number of samples.
+	 */
+	void decode(std::size_t first, std::size_t last, T* decoded) const;
+
+private:
+
+	std::size_t N;
+	raw_encoding format;
+
+	std::vector<T> exact_values;
+	std::vector<float> float_values;
+	std::vector<std::int32_t> mantissas_32;
+	std::vector<std::int16_t> mantissas_16;
+	std::vector<int> exponents;
+	std::vector<std::pair<std::size_t, T> > non_finite_values; // by index, not representable by mantissas
+
+	void encode(const std::vector<T>& samples);
+	template<typename M>
+	void encode_shared_exponent(const std::vector<T>& samples, std::vector<M>& mantissas);
+	template<typename M>
+	void decode_shared_exponent(const std::vector<M>& mantissas, std::size_t first, std::size_t last,
+			T* decoded) const;
+
+};
+
+}
+}
+}
+
+#include <detail/RawHistory.tcc>
+
+#endif /* INCLUDE_RAWHISTORY_HH_ */
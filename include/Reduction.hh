@@ -0,0 +1,52 @@
+#ifndef INCLUDE_REDUCTION_HH_
+#define INCLUDE_REDUCTION_HH_
+
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Summation orders of reductions.
+ * sequential: all terms are summed one after another by the calling thread, in the order of a plain loop.
+ * reproducible: terms are summed sequentially in blocks of reduction::block_size terms, and the block sums are
+ * combined in a fixed pairwise tree. Blocks are summed in parallel, but the result only depends on the number of
+ * terms, not on the number of threads. Sums of at most reduction::block_size terms are plain sequential sums.
+ * fast: every thread sums its share of the blocks, and the thread results are combined in the order in which the
+ * threads finish, so the last bits of the result may change from run to run.
+ */
+enum class reduction_mode {
+	sequential, reproducible, fast
+};
+
+namespace reduction {
+
+constexpr std::size_t block_size = 1024;
+
+/**
+ * Reduces the terms [0, n) in the given mode, starting from zero.
+ * accumulate(A& partial, first, last) adds the terms [first, last) to partial, combine(A& partial, const A& other)
+ * adds other to partial. Blocks are accumulated concurrently, so accumulate must not modify shared state, unless
+ * concurrent is false. Then the blocks are accumulated one after another by the calling thread, which gives the
+ * same result.
+ */
+template<typename A, typename Accumulate, typename Combine>
+A reduce(std::size_t n, const A& zero, Accumulate accumulate, Combine combine, reduction_mode mode,
+		bool concurrent = true);
+
+/**
+ * Returns the sum of term(i) for i in [0, n) in the given mode, see reduce(...).
+ */
+template<typename T, typename Term>
+T sum(std::size_t n, Term term, reduction_mode mode, bool concurrent = true);
+
+}
+
+}
+}
+}
+
+#include <detail/Reduction.tcc>
+
+#endif /* INCLUDE_REDUCTION_HH_ */
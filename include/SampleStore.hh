@@ -0,0 +1,145 @@
+#ifndef INCLUDE_SAMPLESTORE_HH_
+#define INCLUDE_SAMPLESTORE_HH_
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Layout policy of SampleStore: the elements of each slot are contiguous.
+ */
+struct contiguous_slots {
+	static constexpr std::size_t lanes = 1;
+};
+
+/**
+ * Layout policy of SampleStore: tiles of L consecutive slots are stored element-major with the slot innermost
+ * ("array of structures of arrays"), i.e. element i of the L slots of a tile is contiguous. Kernels can then
+ * vectorize across slots, which pays off if the slots are short, e.g. for few jackknife bins but many keys.
+ */
+template<std::size_t L = 8>
+struct slot_tiles {
+	static_assert(L > 0, "slot_tiles requires at least one lane");
+	static constexpr std::size_t lanes = L;
+};
+
+/**
+ * Storage for equally sized sample vectors ("slots") of arithmetic type T.
+ * Slots are allocated in pages of contiguous memory, so the storage can grow without moving existing slots.
+ * A page holds as many slots as fit into page_bytes, but at least one (tile of) slot(s), so large slots do not
+ * over-allocate. Pages are allocated when a slot of them is first used and freed as soon as all their slots are
+ * released. Released slots are recycled by subsequent allocations and compact() removes the
+ * holes left by released slots in partially used pages.
+ *
+ * Copies of a SampleStore share their pages. A shared page is copied only before it is written through
+ * mutable_data(...), write(...) or compact(), so copies cost memory only for the pages they modify. Copies may be
+ * read and destroyed in other threads while the original is written, e.g. snapshots published to a QueryServer.
+ *
+ * Element i of a slot is at data(slot)[i * stride()], where the stride is 1 for the Layout contiguous_slots and L for
+ * slot_tiles<L>.
+ */
+template<typename T, typename Layout = contiguous_slots>
+class SampleStore {
+public:
+
+	static constexpr std::size_t default_page_bytes = 1 << 16;
+
+	/**
+	 * Create an empty SampleStore for slots of slot_size elements, allocating memory in pages of about page_bytes.
+	 */
+	SampleStore(std::size_t slot_size = 0, std::size_t page_bytes = default_page_bytes);
+
+	/**
+	 * Returns the index of an unused slot, preferring released slots over new ones.
+	 * The content of the slot is unspecified.
+	 */
+	std::size_t allocate();
+
+	/**
+	 * Marks the slot as unused and frees its page if no other slot of the page is in use.
+	 * Does nothing if the slot is not in use.
+	 */
+	void release(std::size_t slot);
+
+	/**
+	 * Returns the distance of consecutive elements of a slot, i.e. Layout::lanes.
+	 */
+	static constexpr std::size_t stride();
+
+	/**
+	 * Returns a pointer to the first of the slot_size elements of the slot for reading, see stride().
+	 * The pointer stays valid until the next call of mutable_data(...), write(...) or compact().
+	 */
+	const T* data(std::size_t slot) const;
+
+	/**
+	 * Returns a pointer to the first of the slot_size elements of the slot for writing, see stride(), copying its
+	 * page first if it is shared with another SampleStore. The pointer stays valid until the next call of
+	 * mutable_data(...), write(...) or compact().
+	 */
+	T* mutable_data(std::size_t slot);
+
+	/**
+	 * Copies the slot_size elements of the slot to the contiguous memory at elements.
+	 */
+	void read(std::size_t slot, T* elements) const;
+
+	/**
+	 * Copies slot_size elements from the contiguous memory at elements into the slot, see mutable_data(...).
+	 */
+	void write(std::size_t slot, const T* elements);
+
+	/**
+	 * Returns a pointer to the tile containing the slot, i.e. to element 0 of the first slot of the tile, which
+	 * holds slot_size x Layout::lanes elements (row-major), and assigns the lane of the slot within the tile to lane.
+	 */
+	const T* tile_data(std::size_t slot, std::size_t& lane) const;
+
+	/**
+	 * Returns the number of slots in use.
+	 */
+	std::size_t size() const;
+
+	/**
+	 * Returns the number of slots for which memory is allocated.
+	 */
+	std::size_t capacity() const;
+
+	/**
+	 * Returns the number of slots per page.
+	 */
+	std::size_t page_size() const;
+
+	/**
+	 * Moves the slots in use to the lowest slot indices and frees pages which are no longer needed.
+	 * Returns a vector which maps each old slot index to the new slot index of the same data.
+	 * Entries for unused old slots are unspecified.
+	 */
+	std::vector<std::size_t> compact();
+
+private:
+
+	std::size_t slot_size;
+	std::size_t slots_per_page;
+
+	std::vector<std::shared_ptr<T> > pages; // empty for pages without used slots
+	std::vector<std::size_t> page_slots_used;
+	std::vector<bool> slot_used;
+	std::vector<std::size_t> free_slots;
+
+	std::size_t offset(std::size_t slot) const;
+	std::shared_ptr<T> new_page() const;
+
+};
+
+}
+}
+}
+
+#include <detail/SampleStore.tcc>
+
+#endif /* INCLUDE_SAMPLESTORE_HH_ */
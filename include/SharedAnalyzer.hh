@@ -0,0 +1,132 @@
+#ifndef INCLUDE_SHAREDANALYZER_HH_
+#define INCLUDE_SHAREDANALYZER_HH_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+#include <JackknifeAnalyzer.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Read-only view of the state of a JackknifeAnalyzer published in a POSIX shared memory segment, which any number
+ * of processes can attach to without copying the jackknife samples. POSIX only; may require linking with librt.
+ *
+ * The segment holds the number of bins, a table of all keys sorted by name with mean, jackknife error and bias, and
+ * the jackknife samples of all non-terminal variables as one row-major matrix. Keys are identified by names given
+ * at publication, so readers need not know the key type of the analyzer.
+ */
+template<typename T>
+class SharedAnalyzer {
+public:
+
+	/**
+	 * Publishes the state of analyzer in the shared memory segment segment_name (e.g. "/my_analysis"), replacing a
+	 * previously published segment of the same name. Processes attached to the previous segment keep their view of
+	 * it. The segment is marked as published only after all of its contents are written, so attaching while it is
+	 * written or replaced throws instead of showing incomplete data, and can be retried.
+	 * key_name must map different keys to different names.
+	 * Throws if the segment cannot be created.
+	 */
+	template<typename K, typename Layout>
+	static void publish(const std::string& segment_name, const JackknifeAnalyzer<K, T, Layout>& analyzer,
+			std::function<std::string(const K&)> key_name);
+
+	/**
+	 * Removes the segment segment_name. Attached processes keep their view of it until they detach.
+	 */
+	static void unlink(const std::string& segment_name);
+
+	/**
+	 * Attaches read-only to the published segment segment_name. All offsets in the segment are checked against its
+	 * size, so a damaged segment is rejected instead of read out of bounds.
+	 * Throws if the segment does not exist, is not completely published or was not published by SharedAnalyzer<T>.
+	 */
+	SharedAnalyzer(const std::string& segment_name);
+
+	/**
+	 * Detaches from the segment.
+	 */
+	~SharedAnalyzer();
+
+	SharedAnalyzer(const SharedAnalyzer&) = delete;
+	SharedAnalyzer& operator=(const SharedAnalyzer&) = delete;
+
+	std::size_t num_bins() const;
+
+	/**
+	 * Returns the names of all variables, sorted.
+	 */
+	std::vector<std::string> keys() const;
+
+	/**
+	 * If the variable named Xkey exists, assigns its mean / jackknife error to mu_X / sigma_X and returns true.
+	 * Otherwise does nothing and returns false.
+	 */
+	bool jackknife(const std::string& Xkey, T& mu_X, T& sigma_X) const;
+
+	/**
+	 * Same as JackknifeAnalyzer::mu(...), sigma(...), bias(...) for the variable named Xkey.
+	 * Throw std::out_of_range if Xkey does not exist.
+	 */
+	T mu(const std::string& Xkey) const;
+	T sigma(const std::string& Xkey) const;
+	T bias(const std::string& Xkey) const;
+
+	/**
+	 * Returns a pointer to the num_bins() jackknife samples of the variable named Xkey in the shared segment.
+	 * The pointer stays valid until the SharedAnalyzer is destroyed.
+	 * Throws if Xkey does not exist or is a terminal variable.
+	 */
+	const T* samples(const std::string& Xkey) const;
+
+	/**
+	 * Same as JackknifeAnalyzer::covariance(...) for the variables named Xkey and Ykey. The sum over bins is
+	 * accumulated in at least double precision.
+	 */
+	T covariance(const std::string& Xkey, const std::string& Ykey) const;
+
+private:
+
+	static constexpr std::uint64_t magic = 0x4a4b534841524544; // "JKSHARED"
+	static constexpr std::uint64_t no_samples = static_cast<std::uint64_t>(-1);
+
+	struct segment_header {
+		std::uint64_t magic;
+		std::uint64_t value_size;
+		std::uint64_t num_bins;
+		std::uint64_t num_keys;
+		std::uint64_t names_offset;
+		std::uint64_t samples_offset;
+	};
+
+	struct key_entry {
+		std::uint64_t name_offset, name_length; // relative to names_offset
+		std::uint64_t samples_row; // no_samples for terminal variables
+		T mu, sigma, bias;
+	};
+
+	const unsigned char* segment;
+	std::size_t segment_size;
+
+	bool is_consistent() const;
+	const segment_header& header() const;
+	const key_entry* entries() const;
+	std::string name(const key_entry& entry) const;
+	const key_entry& find(const std::string& Xkey) const;
+	const key_entry* find_entry(const std::string& Xkey) const;
+
+};
+
+}
+}
+}
+
+#include <detail/SharedAnalyzer.tcc>
+
+#endif /* INCLUDE_SHAREDANALYZER_HH_ */
@@ -0,0 +1,93 @@
+#ifndef INCLUDE_STREAMINGJACKKNIFE_HH_
+#define INCLUDE_STREAMINGJACKKNIFE_HH_
+
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <type_traits>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+/**
+ * Jackknife over a sliding window of the most recent bins of a stream of samples of arithmetic type T, e.g. to monitor
+ * drift of an observable while configurations are generated.
+ *
+ * Samples are summed into bins of bin_size consecutive samples as in JackknifeAnalyzer::resample(...). The window
+ * holds the last window_bins complete bins; samples of the incomplete bin are not used yet. Running sums of the bin
+ * sums and their squares are updated in O(1) when a bin enters or leaves the window, so mean and jackknife error are
+ * available at any time without revisiting the history. The running sums are recomputed from the window once per
+ * window_bins removed bins to limit the accumulation of rounding errors.
+ */
+template<typename T>
+class StreamingJackknife {
+public:
+
+	/**
+	 * Create an empty window of window_bins bins with bin_size samples each.
+	 * Throws if window_bins is less than 2 or bin_size is 0.
+	 */
+	StreamingJackknife(std::size_t window_bins, std::size_t bin_size = 1);
+
+	/**
+	 * Adds the next sample of the stream. Completes a bin every bin_size samples, which removes the oldest bin if the
+	 * window is full.
+	 */
+	void add(const T& sample);
+
+	/**
+	 * Returns the number of complete bins in the window.
+	 */
+	std::size_t num_bins() const;
+
+	/**
+	 * If the window holds at least 2 bins, assigns mean and jackknife error of the samples in the window to
+	 * mu / sigma and returns true. Otherwise does nothing and returns false.
+	 */
+	bool jackknife(T& mu, T& sigma) const;
+
+	/**
+	 * Returns the mean of the samples in the window. Throws if the window holds less than 2 bins.
+	 */
+	T mu() const;
+
+	/**
+	 * Returns the jackknife error of the samples in the window. Throws if the window holds less than 2 bins.
+	 */
+	T sigma() const;
+
+	/**
+	 * Returns the jackknife samples of the window, oldest bin first, e.g. for JackknifeAnalyzer::add_resampled(...).
+	 * Throws if the window holds less than 2 bins.
+	 */
+	std::vector<T> samples() const;
+
+private:
+
+	std::size_t window_bins;
+	std::size_t bin_size;
+
+	std::deque<T> bin_sums;
+	T current_bin_sum;
+	std::size_t current_bin_samples;
+
+	// the running sums are updated with every bin entering or leaving the window, so they are accumulated in at least
+	// double precision
+	using running_sum = typename std::common_type<T, double>::type;
+	running_sum shift; // subtracted from the bin sums in the running sums to avoid cancellations
+	running_sum shifted_sum, shifted_squares;
+	std::size_t removed_since_recompute;
+
+	void recompute();
+	void verify_num_bins() const;
+
+};
+
+}
+}
+}
+
+#include <detail/StreamingJackknife.tcc>
+
+#endif /* INCLUDE_STREAMINGJACKKNIFE_HH_ */
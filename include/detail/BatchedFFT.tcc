@@ -0,0 +1,132 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <BatchedFFT.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T>
+BatchedFFT<T>::BatchedFFT(const std::vector<std::size_t>& extents, int sign) :
+		N_points { 1 } {
+
+	if (extents.empty())
+		throw std::runtime_error("trying to create Fourier transform without extents.");
+	if (sign != -1 && sign != 1)
+		throw std::runtime_error("trying to create Fourier transform with sign other than -1 or 1.");
+
+	for (const std::size_t length : extents)
+		if (length == 0)
+			throw std::runtime_error("trying to create Fourier transform with empty extent.");
+		else
+			N_points *= length;
+
+	std::size_t stride = N_points;
+	const T pi = acos((T) -1);
+	for (const std::size_t length : extents) {
+		stride /= length;
+		axis a { length, stride, (length & (length - 1)) == 0, std::vector<T>(length), std::vector<T>(length) };
+		for (std::size_t j = 0; j < length; ++j) {
+			const T phase = sign * 2 * pi * static_cast<T>(j) / static_cast<T>(length);
+			a.twiddle_re[j] = cos(phase);
+			a.twiddle_im[j] = sin(phase);
+		}
+		axes.push_back(std::move(a));
+	}
+}
+
+template<typename T>
+std::size_t BatchedFFT<T>::size() const {
+	return N_points;
+}
+
+template<typename T>
+void BatchedFFT<T>::transform(T* re, T* im, std::size_t batch) const {
+	for (const axis& a : axes) {
+		// lines along the axis start at points outer * length * stride + inner with inner < stride
+		const std::size_t num_lines = N_points / a.length;
+#pragma omp parallel for schedule(static)
+		for (std::size_t line = 0; line < num_lines; ++line) {
+			const std::size_t first = (line / a.stride) * a.length * a.stride + line % a.stride;
+			transform_line(a, re + first * batch, im + first * batch, batch);
+		}
+	}
+}
+
+// ************************************** private **************************************
+
+template<typename T>
+void BatchedFFT<T>::transform_line(const axis& a, T* re, T* im, std::size_t batch) const {
+	const std::size_t n = a.length, step = a.stride * batch;
+	if (n == 1)
+		return;
+
+	// contiguous copy of the line, length x batch
+	std::vector<T> line_re(n * batch), line_im(n * batch);
+	for (std::size_t j = 0; j < n; ++j) {
+		std::copy(re + j * step, re + j * step + batch, &line_re[j * batch]);
+		std::copy(im + j * step, im + j * step + batch, &line_im[j * batch]);
+	}
+
+	if (a.radix_2) {
+		for (std::size_t j = 1, reversed = 0; j < n; ++j) { // bit reversal permutation
+			std::size_t bit = n >> 1;
+			for (; reversed & bit; bit >>= 1)
+				reversed ^= bit;
+			reversed ^= bit;
+			if (j < reversed) {
+				std::swap_ranges(&line_re[j * batch], &line_re[j * batch] + batch, &line_re[reversed * batch]);
+				std::swap_ranges(&line_im[j * batch], &line_im[j * batch] + batch, &line_im[reversed * batch]);
+			}
+		}
+
+		for (std::size_t length = 2; length <= n; length <<= 1)
+			for (std::size_t first = 0; first < n; first += length)
+				for (std::size_t j = 0; j < length / 2; ++j) {
+					const T w_re = a.twiddle_re[j * (n / length)], w_im = a.twiddle_im[j * (n / length)];
+					T* u_re = &line_re[(first + j) * batch];
+					T* u_im = &line_im[(first + j) * batch];
+					T* v_re = &line_re[(first + j + length / 2) * batch];
+					T* v_im = &line_im[(first + j + length / 2) * batch];
+#pragma omp simd
+					for (std::size_t i = 0; i < batch; ++i) {
+						const T t_re = w_re * v_re[i] - w_im * v_im[i];
+						const T t_im = w_re * v_im[i] + w_im * v_re[i];
+						v_re[i] = u_re[i] - t_re;
+						v_im[i] = u_im[i] - t_im;
+						u_re[i] += t_re;
+						u_im[i] += t_im;
+					}
+				}
+
+		for (std::size_t j = 0; j < n; ++j) {
+			std::copy(&line_re[j * batch], &line_re[j * batch] + batch, re + j * step);
+			std::copy(&line_im[j * batch], &line_im[j * batch] + batch, im + j * step);
+		}
+	} else {
+		for (std::size_t k = 0; k < n; ++k) {
+			T* out_re = re + k * step;
+			T* out_im = im + k * step;
+			std::fill(out_re, out_re + batch, (T) 0);
+			std::fill(out_im, out_im + batch, (T) 0);
+			for (std::size_t j = 0; j < n; ++j) {
+				const T w_re = a.twiddle_re[(j * k) % n], w_im = a.twiddle_im[(j * k) % n];
+				const T* in_re = &line_re[j * batch];
+				const T* in_im = &line_im[j * batch];
+#pragma omp simd
+				for (std::size_t i = 0; i < batch; ++i) {
+					out_re[i] += w_re * in_re[i] - w_im * in_im[i];
+					out_im[i] += w_re * in_im[i] + w_im * in_re[i];
+				}
+			}
+		}
+	}
+}
+
+}
+}
+}
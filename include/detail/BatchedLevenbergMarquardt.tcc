@@ -0,0 +1,214 @@
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+
+#include <BatchedLevenbergMarquardt.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T, std::size_t W>
+constexpr std::size_t BatchedLevenbergMarquardt<T, W>::lanes;
+
+template<typename T, std::size_t W>
+BatchedLevenbergMarquardt<T, W>::BatchedLevenbergMarquardt(std::size_t num_points, std::size_t num_parameters,
+		const std::vector<T>& sigmas, std::size_t max_iterations, T tolerance) :
+		N_points { num_points }, N_params { num_parameters }, max_iterations { max_iterations }, tolerance { tolerance } {
+
+	if (sigmas.size() != N_points)
+		throw std::runtime_error("trying to fit with different numbers of data points and errors.");
+	for (const T& sigma : sigmas)
+		inverse_sigmas.push_back(1 / sigma);
+}
+
+template<typename T, std::size_t W>
+template<typename Model>
+void BatchedLevenbergMarquardt<T, W>::solve(Model& model, const T* const * y_columns, std::size_t num_lanes,
+		T* params, T* chi2) const {
+	const std::size_t P = N_params;
+	std::vector<T> JtJ(P * P * W), Jtr(P * W), A(P * P * W), step(P * W), trial(P * W);
+	std::vector<T> current_chi2(W), trial_chi2(W), lambda(W, (T) 1e-3);
+	std::vector<T> updated_JtJ(P * P * W), updated_Jtr(P * W), updated_chi2(W);
+	std::vector<char> active(W), accepted(W), regular(W), needs_update(W), singular(W, false);
+	for (std::size_t l = 0; l < W; ++l)
+		active[l] = l < num_lanes;
+
+	// damping scales the diagonal of JtJ, so a lane with a zero diagonal element can never take a step
+	const auto stop_singular_lanes = [&]() {
+		for (std::size_t j = 0; j < P; ++j)
+			for (std::size_t l = 0; l < W; ++l)
+				if (active[l] && !(JtJ[(j * P + j) * W + l] > 0)) {
+					active[l] = false;
+					singular[l] = true;
+				}
+	};
+
+	evaluate(model, y_columns, active, params, current_chi2.data(), JtJ.data(), Jtr.data());
+	stop_singular_lanes();
+
+	for (std::size_t iteration = 0; iteration < max_iterations; ++iteration) {
+		if (std::find(active.begin(), active.end(), 1) == active.end())
+			break;
+
+		// damped normal equations (JtJ + lambda diag(JtJ)) step = Jtr, Cholesky factorization lane-wise
+		for (std::size_t jk = 0; jk < P * P; ++jk) {
+			const bool diagonal = jk % (P + 1) == 0;
+#pragma omp simd
+			for (std::size_t l = 0; l < W; ++l)
+				A[jk * W + l] = JtJ[jk * W + l] * (diagonal ? 1 + lambda[l] : 1);
+		}
+		regular = active;
+		for (std::size_t j = 0; j < P; ++j) {
+			for (std::size_t k = 0; k < j; ++k)
+#pragma omp simd
+				for (std::size_t l = 0; l < W; ++l)
+					A[(j * P + j) * W + l] -= A[(j * P + k) * W + l] * A[(j * P + k) * W + l];
+#pragma omp simd
+			for (std::size_t l = 0; l < W; ++l) {
+				const T diag = A[(j * P + j) * W + l];
+				regular[l] = regular[l] && diag > 0;
+				A[(j * P + j) * W + l] = regular[l] ? sqrt(diag) : 1;
+			}
+			for (std::size_t i = j + 1; i < P; ++i) {
+				for (std::size_t k = 0; k < j; ++k)
+#pragma omp simd
+					for (std::size_t l = 0; l < W; ++l)
+						A[(i * P + j) * W + l] -= A[(i * P + k) * W + l] * A[(j * P + k) * W + l];
+#pragma omp simd
+				for (std::size_t l = 0; l < W; ++l)
+					A[(i * P + j) * W + l] /= A[(j * P + j) * W + l];
+			}
+		}
+		std::copy(Jtr.begin(), Jtr.end(), step.begin());
+		for (std::size_t i = 0; i < P; ++i) {
+			for (std::size_t k = 0; k < i; ++k)
+#pragma omp simd
+				for (std::size_t l = 0; l < W; ++l)
+					step[i * W + l] -= A[(i * P + k) * W + l] * step[k * W + l];
+#pragma omp simd
+			for (std::size_t l = 0; l < W; ++l)
+				step[i * W + l] /= A[(i * P + i) * W + l];
+		}
+		for (std::size_t i = P; i-- > 0;) {
+			for (std::size_t k = i + 1; k < P; ++k)
+#pragma omp simd
+				for (std::size_t l = 0; l < W; ++l)
+					step[i * W + l] -= A[(k * P + i) * W + l] * step[k * W + l];
+#pragma omp simd
+			for (std::size_t l = 0; l < W; ++l)
+				step[i * W + l] /= A[(i * P + i) * W + l];
+		}
+
+		for (std::size_t j = 0; j < P; ++j)
+#pragma omp simd
+			for (std::size_t l = 0; l < W; ++l)
+				trial[j * W + l] = params[j * W + l] + (regular[l] ? step[j * W + l] : 0);
+
+		evaluate(model, y_columns, regular, trial.data(), trial_chi2.data(), nullptr, nullptr);
+
+		for (std::size_t l = 0; l < W; ++l) {
+			accepted[l] = regular[l] && trial_chi2[l] < current_chi2[l];
+			if (accepted[l]) {
+				if (current_chi2[l] - trial_chi2[l] <= tolerance * current_chi2[l])
+					active[l] = false;
+				current_chi2[l] = trial_chi2[l];
+				lambda[l] /= 10;
+			} else if (active[l]) {
+				lambda[l] *= 10;
+				if (lambda[l] > (T) 1e12) // no further decrease of chi^2 possible
+					active[l] = false;
+			}
+		}
+		for (std::size_t j = 0; j < P; ++j)
+#pragma omp simd
+			for (std::size_t l = 0; l < W; ++l)
+				params[j * W + l] = accepted[l] ? trial[j * W + l] : params[j * W + l];
+
+		for (std::size_t l = 0; l < W; ++l)
+			needs_update[l] = accepted[l] && active[l];
+		if (std::find(needs_update.begin(), needs_update.end(), 1) != needs_update.end()) {
+			evaluate(model, y_columns, needs_update, params, updated_chi2.data(), updated_JtJ.data(),
+					updated_Jtr.data());
+			for (std::size_t jk = 0; jk < P * P; ++jk)
+				for (std::size_t l = 0; l < W; ++l)
+					if (needs_update[l])
+						JtJ[jk * W + l] = updated_JtJ[jk * W + l];
+			for (std::size_t j = 0; j < P; ++j)
+				for (std::size_t l = 0; l < W; ++l)
+					if (needs_update[l])
+						Jtr[j * W + l] = updated_Jtr[j * W + l];
+			stop_singular_lanes();
+		}
+	}
+
+	for (std::size_t j = 0; j < P; ++j)
+		for (std::size_t l = 0; l < W; ++l)
+			if (singular[l])
+				params[j * W + l] = std::numeric_limits<T>::quiet_NaN();
+
+	if (chi2)
+		std::copy(current_chi2.begin(), current_chi2.end(), chi2);
+}
+
+template<typename T, std::size_t W>
+std::size_t BatchedLevenbergMarquardt<T, W>::num_points() const {
+	return N_points;
+}
+
+template<typename T, std::size_t W>
+std::size_t BatchedLevenbergMarquardt<T, W>::num_parameters() const {
+	return N_params;
+}
+
+// ************************************** private **************************************
+
+template<typename T, std::size_t W>
+template<typename Model>
+void BatchedLevenbergMarquardt<T, W>::evaluate(Model& model, const T* const * y_columns,
+		const std::vector<char>& active, const T* params, T* chi2, T* JtJ, T* Jtr) const {
+	const std::size_t P = N_params;
+	std::vector<T> lane_params(P), gradient(P), residuals(W), gradients(P * W);
+
+	std::fill(chi2, chi2 + W, 0);
+	if (JtJ) {
+		std::fill(JtJ, JtJ + P * P * W, 0);
+		std::fill(Jtr, Jtr + P * W, 0);
+	}
+
+	for (std::size_t t = 0; t < N_points; ++t) {
+		for (std::size_t l = 0; l < W; ++l) {
+			if (!active[l]) {
+				residuals[l] = 0;
+				for (std::size_t j = 0; j < P; ++j)
+					gradients[j * W + l] = 0;
+				continue;
+			}
+			for (std::size_t j = 0; j < P; ++j)
+				lane_params[j] = params[j * W + l];
+			residuals[l] = (y_columns[t][l] - model(t, lane_params.data(), gradient.data())) * inverse_sigmas[t];
+			for (std::size_t j = 0; j < P; ++j)
+				gradients[j * W + l] = gradient[j] * inverse_sigmas[t];
+		}
+
+#pragma omp simd
+		for (std::size_t l = 0; l < W; ++l)
+			chi2[l] += residuals[l] * residuals[l];
+		if (JtJ)
+			for (std::size_t j = 0; j < P; ++j) {
+#pragma omp simd
+				for (std::size_t l = 0; l < W; ++l)
+					Jtr[j * W + l] += gradients[j * W + l] * residuals[l];
+				for (std::size_t k = 0; k < P; ++k)
+#pragma omp simd
+					for (std::size_t l = 0; l < W; ++l)
+						JtJ[(j * P + k) * W + l] += gradients[j * W + l] * gradients[k * W + l];
+			}
+	}
+}
+
+}
+}
+}
@@ -0,0 +1,111 @@
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include <CorrelatorOperations.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+namespace correlator {
+
+template<typename T>
+linear_terms<T> folding_terms(std::size_t num_times, T parity) {
+	if (num_times == 0)
+		throw std::runtime_error("trying to fold a correlator without time slices.");
+
+	linear_terms<T> terms(num_times / 2 + 1);
+	for (std::size_t t = 0; t < terms.size(); ++t) {
+		const std::size_t mirrored = (num_times - t) % num_times;
+		if (mirrored == t)
+			terms[t] = { { t, (1 + parity) / 2 } };
+		else
+			terms[t] = { { t, (T) 1 / 2 }, { mirrored, parity / 2 } };
+	}
+	return terms;
+}
+
+template<typename T>
+linear_terms<T> averaging_terms(std::size_t num_correlators, std::size_t num_times,
+		const std::vector<std::size_t>& shifts) {
+	if (num_correlators == 0)
+		throw std::runtime_error("trying to average no correlators.");
+	if (!shifts.empty() && shifts.size() != num_correlators)
+		throw std::runtime_error("trying to average correlators with different numbers of correlators and shifts.");
+
+	linear_terms<T> terms(num_times);
+	const T weight = (T) 1 / static_cast<T>(num_correlators);
+	for (std::size_t t = 0; t < num_times; ++t)
+		for (std::size_t e = 0; e < num_correlators; ++e)
+			terms[t].emplace_back(e * num_times + (t + (shifts.empty() ? 0 : shifts[e])) % num_times, weight);
+	return terms;
+}
+
+template<typename T>
+void apply_linear_terms(const linear_terms<T>& terms, const std::vector<const T*>& inputs, std::size_t n,
+		const std::vector<T*>& outputs) {
+	for (std::size_t o = 0; o < terms.size(); ++o) {
+		T* out = outputs[o];
+		for (std::size_t i = 0; i < n; ++i)
+			out[i] = 0;
+		for (const auto& term : terms[o]) {
+			const T* in = inputs[term.first];
+			const T weight = term.second;
+#pragma omp simd
+			for (std::size_t i = 0; i < n; ++i)
+				out[i] += weight * in[i];
+		}
+	}
+}
+
+template<typename T>
+std::vector<std::vector<T> > fold(const std::vector<std::vector<T> >& correlator, T parity) {
+	const linear_terms<T> terms = folding_terms(correlator.size(), parity);
+
+	std::vector<const T*> inputs;
+	for (const std::vector<T>& slice : correlator) {
+		if (slice.size() != correlator.front().size())
+			throw std::runtime_error("trying to fold time slices with different numbers of samples.");
+		inputs.push_back(slice.data());
+	}
+
+	std::vector<std::vector<T> > folded(terms.size(), std::vector<T>(correlator.front().size()));
+	std::vector<T*> outputs;
+	for (std::vector<T>& slice : folded)
+		outputs.push_back(slice.data());
+	apply_linear_terms(terms, inputs, correlator.front().size(), outputs);
+	return folded;
+}
+
+template<typename T>
+std::vector<std::vector<T> > average(const std::vector<std::vector<std::vector<T> > >& correlators,
+		const std::vector<std::size_t>& shifts) {
+	if (correlators.empty())
+		throw std::runtime_error("trying to average no correlators.");
+	const std::size_t num_times = correlators.front().size();
+	const linear_terms<T> terms = averaging_terms<T>(correlators.size(), num_times, shifts);
+
+	std::vector<const T*> inputs;
+	for (const std::vector<std::vector<T> >& correlator : correlators) {
+		if (correlator.size() != num_times)
+			throw std::runtime_error("trying to average correlators with different numbers of time slices.");
+		for (const std::vector<T>& slice : correlator) {
+			if (slice.size() != correlators.front().front().size())
+				throw std::runtime_error("trying to average time slices with different numbers of samples.");
+			inputs.push_back(slice.data());
+		}
+	}
+
+	const std::size_t num_samples = num_times > 0 ? correlators.front().front().size() : 0;
+	std::vector<std::vector<T> > averaged(num_times, std::vector<T>(num_samples));
+	std::vector<T*> outputs;
+	for (std::vector<T>& slice : averaged)
+		outputs.push_back(slice.data());
+	apply_linear_terms(terms, inputs, num_samples, outputs);
+	return averaged;
+}
+
+}
+}
+}
+}
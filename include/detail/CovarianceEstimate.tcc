@@ -0,0 +1,112 @@
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+#include <LinearAlgebra.hh>
+#include <CovarianceEstimate.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T>
+CovarianceEstimate<T>::CovarianceEstimate(const std::vector<T>& samples, const std::vector<T>& means, T shrinkage,
+		T svd_cut) :
+		N { means.size() } {
+
+	if (N == 0 || samples.size() % N != 0 || samples.size() / N < 2)
+		throw std::runtime_error("trying to estimate covariance with inconsistent number of samples.");
+	if (!(shrinkage >= 0 && shrinkage <= 1) || !(svd_cut >= 0 && svd_cut < 1))
+		throw std::runtime_error("trying to estimate covariance with invalid regularization.");
+
+	const std::size_t N_bins = samples.size() / N;
+	std::vector<T> deviations(samples.size());
+	for (std::size_t i = 0; i < N; ++i)
+		for (std::size_t b = 0; b < N_bins; ++b)
+			deviations[i * N_bins + b] = samples[i * N_bins + b] - means[i];
+
+	covariance.resize(N * N);
+	for (std::size_t i = 0; i < N; ++i)
+		for (std::size_t j = 0; j <= i; ++j) {
+			accumulator sum = 0;
+			for (std::size_t b = 0; b < N_bins; ++b)
+				sum += (accumulator) deviations[i * N_bins + b] * deviations[j * N_bins + b];
+			covariance[i * N + j] = covariance[j * N + i] = (T) ((accumulator) (N_bins - 1) / N_bins * sum);
+		}
+
+	for (std::size_t i = 0; i < N; ++i)
+		for (std::size_t j = 0; j < N; ++j)
+			if (i != j)
+				covariance[i * N + j] *= 1 - shrinkage;
+
+	if (svd_cut > 0) {
+		std::vector<T> sqrt_diag(N), correlation(N * N);
+		for (std::size_t i = 0; i < N; ++i)
+			sqrt_diag[i] = sqrt(covariance[i * N + i]);
+		for (std::size_t i = 0; i < N; ++i)
+			for (std::size_t j = 0; j < N; ++j)
+				correlation[i * N + j] = covariance[i * N + j] / (sqrt_diag[i] * sqrt_diag[j]);
+
+		std::vector<T> eigenvalues, eigenvectors;
+		linear_algebra::symmetric_eigensystem(correlation, N, eigenvalues, eigenvectors);
+		const T min_eigenvalue = svd_cut * *std::max_element(eigenvalues.begin(), eigenvalues.end());
+		for (T& eigenvalue : eigenvalues)
+			eigenvalue = std::max(eigenvalue, min_eigenvalue);
+
+		for (std::size_t i = 0; i < N; ++i)
+			for (std::size_t j = 0; j < N; ++j) {
+				accumulator sum = 0;
+				for (std::size_t k = 0; k < N; ++k)
+					sum += (accumulator) eigenvectors[i * N + k] * eigenvalues[k] * eigenvectors[j * N + k];
+				covariance[i * N + j] = (T) (sqrt_diag[i] * sum * sqrt_diag[j]);
+			}
+	}
+
+	factor = covariance;
+	linear_algebra::cholesky_decompose(factor.data(), N);
+	for (std::size_t i = 0; i < N; ++i)
+		for (std::size_t j = i + 1; j < N; ++j)
+			factor[i * N + j] = 0;
+}
+
+template<typename T>
+std::size_t CovarianceEstimate<T>::size() const {
+	return N;
+}
+
+template<typename T>
+const std::vector<T>& CovarianceEstimate<T>::matrix() const {
+	return covariance;
+}
+
+template<typename T>
+const std::vector<T>& CovarianceEstimate<T>::cholesky_factor() const {
+	return factor;
+}
+
+template<typename T>
+void CovarianceEstimate<T>::whiten(const T* residuals, T* whitened) const {
+	std::copy(residuals, residuals + N, whitened);
+	linear_algebra::forward_substitute(factor.data(), N, whitened);
+}
+
+template<typename T>
+T CovarianceEstimate<T>::chi2(const T* residuals) const {
+	std::vector<T> whitened(N);
+	whiten(residuals, whitened.data());
+	accumulator sum = 0;
+	for (const T& w : whitened)
+		sum += (accumulator) w * w;
+	return (T) sum;
+}
+
+template<typename T>
+void CovarianceEstimate<T>::solve(const T* rhs, T* solution) const {
+	std::copy(rhs, rhs + N, solution);
+	linear_algebra::cholesky_solve(factor.data(), N, solution);
+}
+
+}
+}
+}
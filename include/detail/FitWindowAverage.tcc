@@ -0,0 +1,176 @@
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <LinearAlgebra.hh>
+#include <FitWindowAverage.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T>
+FitWindowAverage<T>::FitWindowAverage(const std::vector<T>& model, std::size_t num_parameters,
+		const std::vector<T>& sigmas, std::size_t min_window_length) :
+		N_points { sigmas.size() }, N_params { num_parameters }, sigmas(sigmas) {
+
+	verify_sizes(model, sigmas.size(), min_window_length);
+
+	whitening_block block { 0, { }, std::vector<T>(model.size()) };
+	for (std::size_t t = 0; t < N_points; ++t)
+		for (std::size_t j = 0; j < N_params; ++j)
+			block.design[t * N_params + j] = model[t * N_params + j] / sigmas[t];
+	blocks.push_back(std::move(block));
+
+	add_windows(0, 0, N_points, min_window_length);
+}
+
+template<typename T>
+FitWindowAverage<T>::FitWindowAverage(const std::vector<T>& model, std::size_t num_parameters,
+		const CovarianceEstimate<T>& covariance, std::size_t min_window_length) :
+		N_points { covariance.size() }, N_params { num_parameters } {
+
+	verify_sizes(model, covariance.size(), min_window_length);
+
+	for (std::size_t first = 0; first + min_window_length <= N_points; ++first) {
+		const std::size_t n = N_points - first;
+		whitening_block block { first, std::vector<T>(n * n), std::vector<T>(n * N_params) };
+		for (std::size_t i = 0; i < n; ++i)
+			for (std::size_t j = 0; j < n; ++j)
+				block.whitening_factor[i * n + j] = covariance.matrix()[(first + i) * N_points + first + j];
+		linear_algebra::cholesky_decompose(block.whitening_factor.data(), n);
+
+		std::vector<T> column(n);
+		for (std::size_t j = 0; j < N_params; ++j) {
+			for (std::size_t i = 0; i < n; ++i)
+				column[i] = model[(first + i) * N_params + j];
+			linear_algebra::forward_substitute(block.whitening_factor.data(), n, column.data());
+			for (std::size_t i = 0; i < n; ++i)
+				block.design[i * N_params + j] = column[i];
+		}
+		blocks.push_back(std::move(block));
+
+		add_windows(blocks.size() - 1, first, first + 1, min_window_length);
+	}
+}
+
+template<typename T>
+void FitWindowAverage<T>::average(const T* y, T* params) const {
+	std::vector<T> z;
+	std::vector<prefix_sum> prefix_az, prefix_zz;
+	std::vector<T> rhs(N_params), window_params(N_params);
+	T min_AIC = std::numeric_limits<T>::max(), sum_weights = 0;
+	for (std::size_t j = 0; j < N_params; ++j)
+		params[j] = 0;
+
+	std::size_t current_block = blocks.size();
+	for (const window& w : windows) {
+		const whitening_block& block = blocks[w.block];
+		if (w.block != current_block) { // whitened data and its prefix sums relative to the start of the block
+			const std::size_t n = N_points - block.first;
+			z.assign(y + block.first, y + N_points);
+			if (block.whitening_factor.empty())
+				for (std::size_t i = 0; i < n; ++i)
+					z[i] /= sigmas[block.first + i];
+			else
+				linear_algebra::forward_substitute(block.whitening_factor.data(), n, z.data());
+
+			prefix_az.assign((n + 1) * N_params, 0);
+			prefix_zz.assign(n + 1, 0);
+			for (std::size_t i = 0; i < n; ++i) {
+				for (std::size_t j = 0; j < N_params; ++j)
+					prefix_az[(i + 1) * N_params + j] = prefix_az[i * N_params + j]
+							+ static_cast<prefix_sum>(block.design[i * N_params + j]) * z[i];
+				prefix_zz[i + 1] = prefix_zz[i] + static_cast<prefix_sum>(z[i]) * z[i];
+			}
+			current_block = w.block;
+		}
+
+		const std::size_t first = w.first - block.first, last = w.last - block.first;
+		for (std::size_t j = 0; j < N_params; ++j)
+			rhs[j] = window_params[j] = static_cast<T>(prefix_az[last * N_params + j] - prefix_az[first * N_params + j]);
+		linear_algebra::cholesky_solve(w.cholesky.data(), N_params, window_params.data());
+
+		prefix_sum chi2 = prefix_zz[last] - prefix_zz[first];
+		for (std::size_t j = 0; j < N_params; ++j)
+			chi2 -= static_cast<prefix_sum>(rhs[j]) * window_params[j];
+
+		const T AIC = static_cast<T>(chi2) + 2 * N_params + 2 * (N_points - (w.last - w.first));
+		if (AIC < min_AIC) { // keep weights relative to the best window to avoid underflow
+			const T rescale = sum_weights > 0 ? exp((AIC - min_AIC) / 2) : 0;
+			sum_weights *= rescale;
+			for (std::size_t j = 0; j < N_params; ++j)
+				params[j] *= rescale;
+			min_AIC = AIC;
+		}
+
+		const T weight = exp(-(AIC - min_AIC) / 2);
+		sum_weights += weight;
+		for (std::size_t j = 0; j < N_params; ++j)
+			params[j] += weight * window_params[j];
+	}
+
+	for (std::size_t j = 0; j < N_params; ++j)
+		params[j] /= sum_weights;
+}
+
+template<typename T>
+std::size_t FitWindowAverage<T>::num_points() const {
+	return N_points;
+}
+
+template<typename T>
+std::size_t FitWindowAverage<T>::num_parameters() const {
+	return N_params;
+}
+
+template<typename T>
+std::size_t FitWindowAverage<T>::num_windows() const {
+	return windows.size();
+}
+
+// ************************************** private **************************************
+
+template<typename T>
+void FitWindowAverage<T>::verify_sizes(const std::vector<T>& model, std::size_t num_points,
+		std::size_t min_window_length) const {
+	if (N_params == 0 || model.size() != num_points * N_params)
+		throw std::runtime_error("trying to fit with inconsistent model size.");
+	if (min_window_length <= N_params)
+		throw std::runtime_error("trying to fit windows with less points than parameters + 1.");
+	if (min_window_length > num_points)
+		throw std::runtime_error("trying to fit without any window of sufficient length.");
+}
+
+template<typename T>
+void FitWindowAverage<T>::add_windows(std::size_t block, std::size_t first_begin, std::size_t first_end,
+		std::size_t min_window_length) {
+	const whitening_block& b = blocks[block];
+
+	// prefix sums of a_t a_t^T over the whitened model of the block
+	const std::size_t n = N_points - b.first, N_params2 = N_params * N_params;
+	std::vector<prefix_sum> prefix((n + 1) * N_params2, 0);
+	for (std::size_t i = 0; i < n; ++i) {
+		const T* a = &b.design[i * N_params];
+		for (std::size_t j = 0; j < N_params; ++j)
+			for (std::size_t k = 0; k < N_params; ++k)
+				prefix[(i + 1) * N_params2 + j * N_params + k] = prefix[i * N_params2 + j * N_params + k]
+						+ static_cast<prefix_sum>(a[j]) * a[k];
+	}
+
+	for (std::size_t first = first_begin; first < first_end; ++first)
+		for (std::size_t last = first + min_window_length; last <= N_points; ++last) {
+			window w { block, first, last, std::vector<T>(N_params2) };
+			for (std::size_t jk = 0; jk < N_params2; ++jk)
+				w.cholesky[jk] = static_cast<T>(prefix[(last - b.first) * N_params2 + jk]
+						- prefix[(first - b.first) * N_params2 + jk]);
+			linear_algebra::cholesky_decompose(w.cholesky.data(), N_params);
+			windows.push_back(std::move(w));
+		}
+}
+
+}
+}
+}
@@ -0,0 +1,96 @@
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ForkedEvaluation.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T, typename Evaluate>
+void evaluate_forked(std::size_t n, std::size_t num_processes, Evaluate evaluate, T* results) {
+	static_assert(std::is_trivially_copyable<T>::value, "evaluate_forked requires a trivially copyable type");
+
+	num_processes = std::min(num_processes, n);
+	if (num_processes <= 1 || process_is_multithreaded()) {
+		for (std::size_t i = 0; i < n; ++i)
+			results[i] = evaluate(i);
+		return;
+	}
+
+	void* mapped = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (mapped == MAP_FAILED)
+		throw std::runtime_error("could not map memory shared with worker processes.");
+	T* shared_results = static_cast<T*>(mapped);
+
+	// process p evaluates [p * n / num_processes, (p + 1) * n / num_processes)
+	std::vector<pid_t> workers;
+	std::vector<std::size_t> unstarted;
+	for (std::size_t p = 0; p < num_processes; ++p) {
+		const pid_t pid = fork();
+		if (pid == 0) {
+			try {
+				for (std::size_t i = p * n / num_processes; i < (p + 1) * n / num_processes; ++i)
+					shared_results[i] = evaluate(i);
+			} catch (...) {
+				_exit(1);
+			}
+			_exit(0);
+		}
+		if (pid > 0)
+			workers.push_back(pid);
+		else
+			unstarted.push_back(p);
+	}
+
+	bool failed = false;
+	try {
+		for (const std::size_t p : unstarted)
+			for (std::size_t i = p * n / num_processes; i < (p + 1) * n / num_processes; ++i)
+				shared_results[i] = evaluate(i);
+	} catch (...) {
+		failed = true;
+	}
+	for (const pid_t pid : workers) {
+		// a signal handled by the calling process interrupts waiting without affecting the child
+		int status;
+		pid_t waited;
+		do
+			waited = waitpid(pid, &status, 0);
+		while (waited == -1 && errno == EINTR);
+		if (waited != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			failed = true;
+	}
+
+	if (!failed)
+		std::copy(shared_results, shared_results + n, results);
+	munmap(mapped, n * sizeof(T));
+	if (failed)
+		throw std::runtime_error("worker process failed to evaluate function.");
+}
+
+inline bool process_is_multithreaded() {
+	DIR* tasks = opendir("/proc/self/task");
+	if (!tasks)
+		return false;
+	std::size_t num_threads = 0;
+	while (const dirent* task = readdir(tasks))
+		if (std::strcmp(task->d_name, ".") != 0 && std::strcmp(task->d_name, "..") != 0)
+			++num_threads;
+	closedir(tasks);
+	return num_threads > 1;
+}
+
+}
+}
+}
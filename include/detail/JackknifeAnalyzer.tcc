@@ -5,6 +5,20 @@
 #include <cmath>
 #include <type_traits>
 #include <functional>
+#include <initializer_list>
+#include <fstream>
+#include <memory>
+#include <exception>
+#include <string>
+#include <cstdio>
+#include <iterator>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <set>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <helper_functions.hh>
 #include <JackknifeAnalyzer.hh>
@@ -13,147 +27,1077 @@ namespace de_uni_frankfurt_itp {
 namespace reisinger {
 namespace jackknife_analyzer_0219 {
 
-template<typename K, typename T>
-JackknifeAnalyzer<K, T>::JackknifeAnalyzer(std::size_t bin_size) :
-		N_bins { 0 }, bin_size { bin_size } {
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::key_range::key_range(typename mu_map::const_iterator first,
+		typename mu_map::const_iterator last) :
+		first { first }, last { last } {
+}
+
+template<typename K, typename T, typename Layout>
+typename JackknifeAnalyzer<K, T, Layout>::key_range::iterator JackknifeAnalyzer<K, T, Layout>::key_range::begin() const {
+	return iterator { first };
+}
+
+template<typename K, typename T, typename Layout>
+typename JackknifeAnalyzer<K, T, Layout>::key_range::iterator JackknifeAnalyzer<K, T, Layout>::key_range::end() const {
+	return iterator { last };
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::key_range::empty() const {
+	return first == last;
+}
+
+template<typename K, typename T, typename Layout>
+std::size_t JackknifeAnalyzer<K, T, Layout>::key_range::size() const {
+	return std::distance(first, last);
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::JackknifeAnalyzer(std::size_t bin_size) :
+		N_bins { 0 }, bin_size { bin_size }, retain_raw { false }, raw_retention_encoding { raw_encoding::exact },
+				Xs_raw { std::make_shared<raw_map>() }, num_recorded_derivations { 0 }, memory_budget { 0 }, reductions { reduction_mode::sequential } {
 
 	static_assert(std::is_arithmetic<T>::value, "JackknifeAnalyzer data type is not arithmetic");
 }
 
-template<typename K, typename T>
-JackknifeAnalyzer<K, T>::JackknifeAnalyzer(const K& Xkey, const std::vector<T>& Xsamples, std::size_t bin_size) :
-		JackknifeAnalyzer<K, T> { bin_size } {
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::JackknifeAnalyzer(const K& Xkey, const std::vector<T>& Xsamples, std::size_t bin_size) :
+		JackknifeAnalyzer<K, T, Layout> { bin_size } {
 	resample(Xkey, Xsamples);
 }
 
-template<typename K, typename T>
-void JackknifeAnalyzer<K, T>::add_resampled(const K& Xkey, const std::vector<T>& Xjackknife_samples, const T& mu_X) {
-	if (Xs_reduced_samples.count(Xkey) == 0 && Xs_mu.count(Xkey) == 0) {
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_resampled(const K& Xkey, const std::vector<T>& Xjackknife_samples, const T& mu_X) {
+	if (Xs_mu.count(Xkey) == 0) {
 		init_or_verify_N(Xjackknife_samples, true);
 
-		Xs_reduced_samples[Xkey] = Xjackknife_samples;
-		Xs_mu[Xkey] = mu_X;
+		store_samples(Xkey, mu_X, [&Xjackknife_samples](T* X_samples) {
+			std::copy(Xjackknife_samples.begin(), Xjackknife_samples.end(), X_samples);
+		});
 	}
 }
 
-template<typename K, typename T>
-void JackknifeAnalyzer<K, T>::resample(const K& Xkey, const std::vector<T>& Xsamples) {
-	if (Xs_reduced_samples.count(Xkey) == 0 && Xs_mu.count(Xkey) == 0) {
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::resample(const K& Xkey, const std::vector<T>& Xsamples) {
+	if (Xs_mu.count(Xkey) == 0) {
 		init_or_verify_N(Xsamples, false);
 
+		std::vector<T> bin_sums(N_bins), reduced_sums(N_bins);
+		const T sum_samples = sum_into_bins(Xsamples.data(), Xsamples.size(), bin_sums.data(), reduced_sums.data());
+
+		add_reduced_sums(Xkey, bin_sums, reduced_sums, sum_samples, Xsamples.size());
+		if (retain_raw) {
+			unshared(Xs_raw).emplace(Xkey, std::make_shared<const RawHistory<T> >(Xsamples, raw_retention_encoding));
+			store_bin_prefix_sums(Xkey, bin_sums, sum_samples, Xsamples.size());
+		}
+	}
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::resample(const K& Xkey, std::vector<T>&& Xsamples) {
+	if (Xs_mu.count(Xkey) == 0) {
+		init_or_verify_N(Xsamples, false);
+		const std::size_t num_samples = Xsamples.size();
+
+		std::vector<T> reduced_sums(N_bins);
+		if (retain_raw) { // the raw samples are kept, so only their memory can be reused
+			std::vector<T> bin_sums(N_bins);
+			const T sum_samples = sum_into_bins(Xsamples.data(), num_samples, bin_sums.data(), reduced_sums.data());
+
+			add_reduced_sums(Xkey, bin_sums, reduced_sums, sum_samples, num_samples);
+			unshared(Xs_raw).emplace(Xkey, std::make_shared<const RawHistory<T> >(std::move(Xsamples), raw_retention_encoding));
+			store_bin_prefix_sums(Xkey, bin_sums, sum_samples, num_samples);
+		} else {
+			const T sum_samples = sum_into_bins(Xsamples.data(), num_samples, Xsamples.data(), reduced_sums.data());
+			Xsamples.resize(N_bins);
+
+			add_reduced_sums(Xkey, Xsamples, reduced_sums, sum_samples, num_samples);
+		}
+	}
+	std::vector<T>().swap(Xsamples);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::resample_replicas(const K& Xkey, const std::vector<std::vector<T> >& Xreplicas) {
+	if (Xs_mu.count(Xkey) == 0) {
+		// bins of replica r are stored at [first_bins[r], first_bins[r + 1])
+		std::vector<std::size_t> first_bins(Xreplicas.size() + 1, 0), replica_lengths(Xreplicas.size());
+		for (std::size_t r = 0; r < Xreplicas.size(); ++r) {
+			replica_lengths[r] = Xreplicas[r].size();
+			first_bins[r + 1] = first_bins[r] + replica_lengths[r] / bin_size;
+		}
+
+		std::vector<T> bin_sums(first_bins.back(), 0), replica_sums(Xreplicas.size(), 0);
+#pragma omp parallel for schedule(dynamic)
+		for (std::size_t r = 0; r < Xreplicas.size(); ++r) {
+			const std::vector<T>& replica = Xreplicas[r];
+			T replica_sum = 0;
+			for (std::size_t b = first_bins[r]; b < first_bins[r + 1]; ++b) {
+				const T* bin = replica.data() + (b - first_bins[r]) * bin_size;
+				for (std::size_t i = 0; i < bin_size; ++i)
+					bin_sums[b] += bin[i];
+				replica_sum += bin_sums[b];
+			}
+			for (std::size_t i = (first_bins[r + 1] - first_bins[r]) * bin_size; i < replica.size(); ++i)
+				replica_sum += replica[i];
+			replica_sums[r] = replica_sum;
+		}
+
 		T sum_samples = 0;
-		for (T d : Xsamples)
-			sum_samples += d;
-		Xs_mu[Xkey] = sum_samples / static_cast<T>(Xsamples.size());
+		std::size_t num_samples = 0;
+		for (std::size_t r = 0; r < Xreplicas.size(); ++r) {
+			sum_samples += replica_sums[r];
+			num_samples += replica_lengths[r];
+		}
+
+		add_bin_sums(Xkey, bin_sums, sum_samples, num_samples);
+		Xs_replica_lengths.emplace(Xkey, replica_lengths);
+		if (retain_raw) {
+			std::vector<T> concatenated;
+			concatenated.reserve(num_samples);
+			for (const std::vector<T>& replica : Xreplicas)
+				concatenated.insert(concatenated.end(), replica.begin(), replica.end());
+			unshared(Xs_raw).emplace(Xkey, std::make_shared<const RawHistory<T> >(concatenated, raw_retention_encoding));
+			store_bin_prefix_sums(Xkey, bin_sums, sum_samples, num_samples);
+		}
+	}
+}
 
-		std::vector<T> red_samples;
-		red_samples.reserve(N_bins);
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::resample_sources(const K& Xkey, const std::vector<T>& Xsamples, std::size_t num_sources) {
+	T sigma_sources;
+	resample_sources(Xkey, Xsamples, num_sources, sigma_sources);
+}
 
-		for (std::size_t b = 0; b < N_bins; ++b) {
-			T red_sample = sum_samples;
-			const auto next_bin_first_sample = (b + 1) * bin_size;
-			for (std::size_t i = b * bin_size; i < next_bin_first_sample; ++i)
-				red_sample -= Xsamples[i];
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::resample_sources(const K& Xkey, const std::vector<T>& Xsamples, std::size_t num_sources,
+		T& sigma_sources) {
+	if (Xs_mu.count(Xkey) == 0) {
+		if (num_sources == 0 || Xsamples.size() % num_sources != 0)
+			throw std::runtime_error("trying to resample samples which do not match the number of sources.");
 
-			red_samples.push_back(red_sample / static_cast<T>(Xsamples.size() - bin_size));
+		// the means leaving out one source are differences of sums over all configurations, which are therefore
+		// accumulated in at least double precision
+		using source_sum = typename std::common_type<T, double>::type;
+		const std::size_t num_configs = Xsamples.size() / num_sources, num_bins = num_configs / bin_size;
+		std::vector<T> bin_sums(num_bins, 0);
+		std::vector<source_sum> source_sums(num_sources, 0);
+		std::vector<T> config_means(retain_raw ? num_configs : 0);
+		T sum_samples = 0;
+		for (std::size_t c = 0; c < num_configs; ++c) {
+			const T* config = Xsamples.data() + c * num_sources;
+			T config_sum = 0;
+			for (std::size_t s = 0; s < num_sources; ++s) {
+				config_sum += config[s];
+				source_sums[s] += config[s];
+			}
+
+			const T config_mean = config_sum / static_cast<T>(num_sources);
+			if (c < num_bins * bin_size)
+				bin_sums[c / bin_size] += config_mean;
+			sum_samples += config_mean;
+			if (retain_raw)
+				config_means[c] = config_mean;
+		}
+
+		add_bin_sums(Xkey, bin_sums, sum_samples, num_configs);
+		if (retain_raw) {
+			unshared(Xs_raw).emplace(Xkey, std::make_shared<const RawHistory<T> >(config_means, raw_retention_encoding));
+			store_bin_prefix_sums(Xkey, bin_sums, sum_samples, num_configs);
 		}
 
-		Xs_reduced_samples[Xkey] = red_samples;
+		// leaving out source s gives the mean (sum_sources - source_sums[s]) / (num_configs * (num_sources - 1))
+		sigma_sources = 0;
+		if (num_sources > 1) {
+			source_sum sum_sources = 0, squared_deviations = 0;
+			for (std::size_t s = 0; s < num_sources; ++s)
+				sum_sources += source_sums[s];
+			const source_sum mu_X = sum_sources / static_cast<source_sum>(num_configs * num_sources);
+			for (std::size_t s = 0; s < num_sources; ++s)
+				squared_deviations += pow((sum_sources - source_sums[s])
+						/ static_cast<source_sum>(num_configs * (num_sources - 1)) - mu_X, 2);
+			sigma_sources = (T) sqrt((((source_sum) (num_sources - 1)) / ((source_sum) num_sources)) * squared_deviations);
+		}
 	}
 }
 
-template<typename K, typename T>
+template<typename K, typename T, typename Layout>
 template<typename Function>
-void JackknifeAnalyzer<K, T>::add_function(const K& Fkey, Function F, const std::vector<K>& F_arg_keys) {
+void JackknifeAnalyzer<K, T, Layout>::add_function(const K& Fkey, Function F, const std::vector<K>& F_arg_keys) {
 	static_assert(std::is_convertible<Function, std::function<T(std::vector<T>)> >::value,
 			"JackknifeAnalyzer::add_function invalid function");
 
-	if (Xs_reduced_samples.count(Fkey) == 0 && Xs_mu.count(Fkey) == 0) {
+	if (Xs_mu.count(Fkey) == 0) {
 		std::vector<T> args_mu;
 		for (const K& key : F_arg_keys)
 			args_mu.push_back(Xs_mu.at(key));
-		Xs_mu[Fkey] = F(args_mu);
+		const T F_mu = F(args_mu);
+
+		for (const K& key : F_arg_keys)
+			page_in(key); // paging in never evicts
 
-		std::vector<T> F_jackknife_samples;
-		for (std::size_t i = 0; i < N_bins; ++i) {
-			std::vector<T> args_red_samples;
+		store_samples(Fkey, F_mu, [&](T* F_jackknife_samples) {
+			gather_buffer gathered;
+			std::vector<const T*> args_samples;
 			for (const K& key : F_arg_keys)
-				args_red_samples.push_back(Xs_reduced_samples.at(key).at(i));
-			F_jackknife_samples.push_back(F(args_red_samples));
-		}
-		Xs_reduced_samples[Fkey] = F_jackknife_samples;
+				args_samples.push_back(resident_samples(key, gathered));
+
+			std::vector<T> args_red_samples(args_samples.size());
+			for (std::size_t i = 0; i < N_bins; ++i) {
+				for (std::size_t a = 0; a < args_samples.size(); ++a)
+					args_red_samples[a] = args_samples[a][i];
+				F_jackknife_samples[i] = F(args_red_samples);
+			}
+		});
+		record_derivation( { Fkey }, { Fkey }, F_arg_keys, [Fkey, F, F_arg_keys](JackknifeAnalyzer& rebinned) {
+			rebinned.add_function(Fkey, F, F_arg_keys);
+		});
+	}
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Function, typename WorkspaceFactory>
+void JackknifeAnalyzer<K, T, Layout>::add_function_with_workspace(const K& Fkey, Function F, WorkspaceFactory make_workspace,
+		const std::vector<K>& F_arg_keys) {
+	static_assert(std::is_convertible<Function,
+			std::function<T(const std::vector<T>&, decltype(make_workspace())&)> >::value,
+			"JackknifeAnalyzer::add_function_with_workspace invalid function");
+
+	if (Xs_mu.count(Fkey) == 0) {
+		auto mu_workspace = make_workspace();
+		std::vector<T> args_mu;
+		for (const K& key : F_arg_keys)
+			args_mu.push_back(Xs_mu.at(key));
+		const std::vector<T>& const_args_mu = args_mu;
+		const T F_mu = F(const_args_mu, mu_workspace);
+
+		for (const K& key : F_arg_keys)
+			page_in(key); // paging in never evicts
+
+		store_samples(Fkey, F_mu, [&](T* F_jackknife_samples) {
+			gather_buffer gathered;
+			std::vector<const T*> args_samples;
+			for (const K& key : F_arg_keys)
+				args_samples.push_back(resident_samples(key, gathered));
+
+			// exceptions must neither leave the parallel region nor skip the barrier of the loop
+			using Workspace = decltype(make_workspace());
+			std::exception_ptr failure;
+			const auto record_failure = [&failure]() {
+#pragma omp critical
+				if (!failure)
+					failure = std::current_exception();
+			};
+#pragma omp parallel
+			{
+				// the calling thread reuses the workspace of the mean
+				Workspace* workspace = &mu_workspace;
+				std::unique_ptr<Workspace> thread_workspace;
+#ifdef _OPENMP
+				if (omp_get_thread_num() != 0)
+					try {
+						thread_workspace.reset(new Workspace(make_workspace()));
+						workspace = thread_workspace.get();
+					} catch (...) {
+						workspace = nullptr;
+						record_failure();
+					}
+#endif
+				std::vector<T> args_red_samples(args_samples.size());
+				const std::vector<T>& const_args_red_samples = args_red_samples;
+#pragma omp for
+				for (std::size_t i = 0; i < N_bins; ++i)
+					if (workspace)
+						try {
+							for (std::size_t a = 0; a < args_samples.size(); ++a)
+								args_red_samples[a] = args_samples[a][i];
+							F_jackknife_samples[i] = F(const_args_red_samples, *workspace);
+						} catch (...) {
+							record_failure();
+						}
+			}
+			if (failure)
+				std::rethrow_exception(failure);
+		});
+		record_derivation( { Fkey }, { Fkey }, F_arg_keys, [Fkey, F, make_workspace, F_arg_keys](JackknifeAnalyzer& rebinned) {
+			rebinned.add_function_with_workspace(Fkey, F, make_workspace, F_arg_keys);
+		});
+	}
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Function>
+void JackknifeAnalyzer<K, T, Layout>::add_function_forked(const K& Fkey, Function F, const std::vector<K>& F_arg_keys,
+		std::size_t num_processes) {
+	static_assert(std::is_convertible<Function, std::function<T(std::vector<T>)> >::value,
+			"JackknifeAnalyzer::add_function_forked invalid function");
+
+	if (Xs_mu.count(Fkey) == 0) {
+		std::vector<T> args_mu;
+		for (const K& key : F_arg_keys)
+			args_mu.push_back(Xs_mu.at(key));
+		const T F_mu = F(args_mu);
+
+		for (const K& key : F_arg_keys)
+			page_in(key); // paging in never evicts
+
+		store_samples(Fkey, F_mu, [&](T* F_jackknife_samples) {
+			gather_buffer gathered;
+			std::vector<const T*> args_samples;
+			for (const K& key : F_arg_keys)
+				args_samples.push_back(resident_samples(key, gathered));
+
+			std::vector<T> args_red_samples(args_samples.size());
+			evaluate_forked(N_bins, num_processes, [&](std::size_t i) {
+				for (std::size_t a = 0; a < args_samples.size(); ++a)
+					args_red_samples[a] = args_samples[a][i];
+				return F(args_red_samples);
+			}, F_jackknife_samples);
+		});
+		record_derivation( { Fkey }, { Fkey }, F_arg_keys, [Fkey, F, F_arg_keys, num_processes](JackknifeAnalyzer& rebinned) {
+			rebinned.add_function_forked(Fkey, F, F_arg_keys, num_processes);
+		});
 	}
 }
 
-template<typename K, typename T>
+template<typename K, typename T, typename Layout>
 template<typename Function, typename ... Ks>
-void JackknifeAnalyzer<K, T>::add_function(const K& Fkey, Function F, const Ks& ... F_arg_keys) {
+void JackknifeAnalyzer<K, T, Layout>::add_function(const K& Fkey, Function F, const Ks& ... F_arg_keys) {
 	static_assert(tools::helper::and_type<std::is_convertible<Ks, K>::value ...>::value,
 			"JackknifeAnalyzer::add_function invalid key type");
 	static_assert(std::is_convertible<Function, std::function<T(decltype(Xs_mu[F_arg_keys])...)> >::value,
 			"JackknifeAnalyzer::add_function invalid function");
 
-	if (Xs_reduced_samples.count(Fkey) == 0 && Xs_mu.count(Fkey) == 0) {
-		const T F_mu = F(Xs_mu.at(F_arg_keys)...); // before [] to be exception safe
-		Xs_mu[Fkey] = F_mu;
+	if (Xs_mu.count(Fkey) == 0) {
+		const T F_mu = F(Xs_mu.at(F_arg_keys)...);
+
+		(void) std::initializer_list<int> { (page_in(F_arg_keys), 0)... }; // paging in never evicts
+
+		store_samples(Fkey, F_mu, [&](T* F_jackknife_samples) {
+			gather_buffer gathered;
+			const std::array<const T*, sizeof...(Ks)> args_samples { { resident_samples(F_arg_keys, gathered)... } };
+			for (std::size_t i = 0; i < N_bins; ++i)
+				F_jackknife_samples[i] = call_on_bin(F, args_samples, i, index_sequence_for<Ks...> { });
+		});
+		record_derivation( { Fkey }, { Fkey }, { F_arg_keys... }, [=](JackknifeAnalyzer& rebinned) {
+			rebinned.add_function(Fkey, F, F_arg_keys...);
+		});
+	}
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Function>
+void JackknifeAnalyzer<K, T, Layout>::add_terminal_function(const K& Fkey, Function F, const std::vector<K>& F_arg_keys) {
+	static_assert(std::is_convertible<Function, std::function<T(std::vector<T>)> >::value,
+			"JackknifeAnalyzer::add_terminal_function invalid function");
+
+	if (Xs_mu.count(Fkey) == 0) {
+		std::vector<T> args_mu;
+		for (const K& key : F_arg_keys)
+			args_mu.push_back(Xs_mu.at(key));
+		const T F_mu = F(args_mu);
+
+		for (const K& key : F_arg_keys)
+			page_in(key);
+		gather_buffer gathered;
+		std::vector<const T*> args_samples;
+		for (const K& key : F_arg_keys)
+			args_samples.push_back(resident_samples(key, gathered));
+
+		std::vector<T> args_red_samples(F_arg_keys.size());
+		store_summary(Fkey, F_mu, [&](std::size_t i) {
+			for (std::size_t a = 0; a < args_samples.size(); ++a)
+				args_red_samples[a] = args_samples[a][i];
+			return F(args_red_samples) - F_mu;
+		});
+		record_derivation( { Fkey }, { Fkey }, F_arg_keys, [Fkey, F, F_arg_keys](JackknifeAnalyzer& rebinned) {
+			rebinned.add_terminal_function(Fkey, F, F_arg_keys);
+		});
+	}
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Function, typename ... Ks>
+void JackknifeAnalyzer<K, T, Layout>::add_terminal_function(const K& Fkey, Function F, const Ks& ... F_arg_keys) {
+	static_assert(tools::helper::and_type<std::is_convertible<Ks, K>::value ...>::value,
+			"JackknifeAnalyzer::add_terminal_function invalid key type");
+	static_assert(std::is_convertible<Function, std::function<T(decltype(Xs_mu[F_arg_keys])...)> >::value,
+			"JackknifeAnalyzer::add_terminal_function invalid function");
+
+	if (Xs_mu.count(Fkey) == 0) {
+		const T F_mu = F(Xs_mu.at(F_arg_keys)...);
+
+		(void) std::initializer_list<int> { (page_in(F_arg_keys), 0)... };
+		gather_buffer gathered;
+		const std::array<const T*, sizeof...(Ks)> args_samples { { resident_samples(F_arg_keys, gathered)... } };
 
-		std::vector<T> F_jackknife_samples;
-		for (std::size_t i = 0; i < N_bins; ++i)
-			F_jackknife_samples.push_back(F(Xs_reduced_samples.at(F_arg_keys).at(i)...));
-		Xs_reduced_samples[Fkey] = F_jackknife_samples;
+		store_summary(Fkey, F_mu, [&](std::size_t i) {
+			return call_on_bin(F, args_samples, i, index_sequence_for<Ks...> { }) - F_mu;
+		});
+		record_derivation( { Fkey }, { Fkey }, { F_arg_keys... }, [=](JackknifeAnalyzer& rebinned) {
+			rebinned.add_terminal_function(Fkey, F, F_arg_keys...);
+		});
 	}
 }
 
-template<typename K, typename T>
-void JackknifeAnalyzer<K, T>::remove(const K& Xkey) {
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_fit_window_scan(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys,
+		const std::vector<std::function<T(std::size_t)> >& basis, std::size_t min_window_length) {
+	const std::vector<K> added_keys = new_keys(parameter_keys);
+	if (added_keys.empty())
+		return;
+
+	std::vector<T> y_sigmas;
+	for (const K& key : y_keys)
+		y_sigmas.push_back(sigma(key));
+
+	add_fit_window_scan(parameter_keys, y_keys,
+			FitWindowAverage<T>(basis_values(basis, y_keys.size()), basis.size(), y_sigmas, min_window_length));
+	record_derivation(parameter_keys, added_keys, y_keys, [=](JackknifeAnalyzer& rebinned) {
+		rebinned.add_fit_window_scan(parameter_keys, y_keys, basis, min_window_length);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_fit_window_scan(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys,
+		const std::vector<std::function<T(std::size_t)> >& basis, const CovarianceEstimate<T>& covariance,
+		std::size_t min_window_length) {
+	if (covariance.size() != y_keys.size())
+		throw std::runtime_error("trying to fit with covariance of different size than the data.");
+
+	const std::vector<K> added_keys = new_keys(parameter_keys);
+	if (added_keys.empty())
+		return;
+
+	add_fit_window_scan(parameter_keys, y_keys,
+			FitWindowAverage<T>(basis_values(basis, y_keys.size()), basis.size(), covariance, min_window_length));
+	record_derivation(parameter_keys, added_keys, y_keys, [=](JackknifeAnalyzer& rebinned) {
+		rebinned.add_fit_window_scan(parameter_keys, y_keys, basis, covariance, min_window_length);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+template<std::size_t W, typename Model>
+void JackknifeAnalyzer<K, T, Layout>::add_nonlinear_fit(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys,
+		Model model, const std::vector<T>& initial_parameters) {
+	if (parameter_keys.size() != initial_parameters.size())
+		throw std::runtime_error("trying to fit with different numbers of parameter keys and initial parameters.");
+
+	const std::vector<K> added_keys = new_keys(parameter_keys);
+	if (added_keys.empty())
+		return;
+
+	const std::size_t N_points = y_keys.size(), N_params = parameter_keys.size();
+	std::vector<T> y_sigmas;
+	for (const K& key : y_keys)
+		y_sigmas.push_back(sigma(key));
+	const BatchedLevenbergMarquardt<T, W> solver(N_points, N_params, y_sigmas);
+
+	for (const K& key : y_keys)
+		page_in(key);
+
+	store_samples(parameter_keys, [&](const std::vector<T*>& P_samples, std::vector<T>& P_mu) {
+		std::vector<T> y_mu;
+		std::vector<const T*> y_mu_columns;
+		for (const K& key : y_keys)
+			y_mu.push_back(Xs_mu.at(key));
+		for (const T& y : y_mu)
+			y_mu_columns.push_back(&y);
+
+		std::vector<T> params(N_params * W);
+		for (std::size_t j = 0; j < N_params; ++j)
+			params[j * W] = initial_parameters[j];
+		solver.solve(model, y_mu_columns.data(), 1, params.data());
+		for (std::size_t j = 0; j < N_params; ++j)
+			P_mu[j] = params[j * W];
+
+		gather_buffer gathered;
+		std::vector<const T*> y_rows;
+		for (const K& key : y_keys)
+			y_rows.push_back(resident_samples(key, gathered));
+
+		// exceptions must neither leave the parallel region nor skip the barrier of the loop
+		const std::size_t N_batches = (N_bins + W - 1) / W;
+		std::exception_ptr failure;
+		const auto record_failure = [&failure]() {
+#pragma omp critical
+			if (!failure)
+				failure = std::current_exception();
+		};
+#pragma omp parallel
+		{
+			std::unique_ptr<Model> thread_model;
+			try {
+				thread_model.reset(new Model(model));
+			} catch (...) {
+				record_failure();
+			}
+			std::vector<const T*> y_columns(N_points);
+			std::vector<T> batch_params(N_params * W);
+#pragma omp for
+			for (std::size_t batch = 0; batch < N_batches; ++batch)
+				if (thread_model)
+					try {
+						const std::size_t first_bin = batch * W, num_lanes = std::min(W, N_bins - first_bin);
+						for (std::size_t t = 0; t < N_points; ++t)
+							y_columns[t] = y_rows[t] + first_bin;
+						for (std::size_t j = 0; j < N_params; ++j)
+							std::fill(&batch_params[j * W], &batch_params[j * W] + W, P_mu[j]);
+
+						solver.solve(*thread_model, y_columns.data(), num_lanes, batch_params.data());
+						for (std::size_t j = 0; j < N_params; ++j)
+							std::copy(&batch_params[j * W], &batch_params[j * W] + num_lanes, P_samples[j] + first_bin);
+					} catch (...) {
+						record_failure();
+					}
+		}
+		if (failure)
+			std::rethrow_exception(failure);
+	});
+	record_derivation(parameter_keys, added_keys, y_keys, [=](JackknifeAnalyzer& rebinned) {
+		rebinned.template add_nonlinear_fit<W>(parameter_keys, y_keys, model, initial_parameters);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_linear_combinations(const std::vector<K>& out_keys, const std::vector<T>& coefficients,
+		const std::vector<K>& in_keys) {
+	if (coefficients.size() != out_keys.size() * in_keys.size())
+		throw std::runtime_error("trying to compute linear combinations with wrong number of coefficients.");
+
+	const std::vector<K> added_keys = new_keys(out_keys);
+	if (added_keys.empty())
+		return;
+
+	for (const K& key : in_keys)
+		page_in(key);
+
+	store_samples(out_keys, [&](const std::vector<T*>& out_samples, std::vector<T>& out_mu) {
+		gather_buffer gathered;
+		std::vector<const T*> in_samples, in_mu;
+		for (const K& key : in_keys) {
+			in_samples.push_back(resident_samples(key, gathered));
+			in_mu.push_back(&Xs_mu.at(key));
+		}
+		std::vector<T*> out_mu_pointers;
+		for (T& mu : out_mu)
+			out_mu_pointers.push_back(&mu);
+
+		linear_algebra::multiply_rows(coefficients.data(), in_samples, N_bins, out_samples);
+		linear_algebra::multiply_rows(coefficients.data(), in_mu, 1, out_mu_pointers);
+	});
+	record_derivation(out_keys, added_keys, in_keys, [=](JackknifeAnalyzer& rebinned) {
+		rebinned.add_linear_combinations(out_keys, coefficients, in_keys);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_fourier_transform(const std::vector<K>& re_out_keys, const std::vector<K>& im_out_keys,
+		const std::vector<K>& re_in_keys, const std::vector<K>& im_in_keys, const std::vector<std::size_t>& extents,
+		int sign) {
+	const BatchedFFT<T> fft(extents, sign);
+	const std::size_t N_points = fft.size();
+	if (re_in_keys.size() != N_points || (!im_in_keys.empty() && im_in_keys.size() != N_points)
+			|| re_out_keys.size() != N_points || im_out_keys.size() != N_points)
+		throw std::runtime_error("trying to Fourier transform with numbers of keys different from the number of points.");
+
+	std::vector<K> out_keys(re_out_keys);
+	out_keys.insert(out_keys.end(), im_out_keys.begin(), im_out_keys.end());
+	const std::vector<K> added_keys = new_keys(out_keys);
+	if (added_keys.empty())
+		return;
+
+	std::vector<K> in_keys(re_in_keys);
+	in_keys.insert(in_keys.end(), im_in_keys.begin(), im_in_keys.end());
+	for (const K& key : in_keys)
+		page_in(key);
+
+	store_samples(out_keys, [&](const std::vector<T*>& out_samples, std::vector<T>& out_mu) {
+		// the means are transformed as an additional bin
+		const std::size_t batch = N_bins + 1;
+		std::vector<T> re(N_points * batch), im(N_points * batch, 0);
+		for (std::size_t x = 0; x < N_points; ++x) {
+			gather_buffer gathered;
+			const T* re_samples = resident_samples(re_in_keys[x], gathered);
+			std::copy(re_samples, re_samples + N_bins, &re[x * batch]);
+			re[x * batch + N_bins] = Xs_mu.at(re_in_keys[x]);
+			if (!im_in_keys.empty()) {
+				const T* im_samples = resident_samples(im_in_keys[x], gathered);
+				std::copy(im_samples, im_samples + N_bins, &im[x * batch]);
+				im[x * batch + N_bins] = Xs_mu.at(im_in_keys[x]);
+			}
+		}
+
+		fft.transform(re.data(), im.data(), batch);
+
+		for (std::size_t k = 0; k < N_points; ++k) {
+			std::copy(&re[k * batch], &re[k * batch] + N_bins, out_samples[k]);
+			std::copy(&im[k * batch], &im[k * batch] + N_bins, out_samples[N_points + k]);
+			out_mu[k] = re[k * batch + N_bins];
+			out_mu[N_points + k] = im[k * batch + N_bins];
+		}
+	});
+	record_derivation(out_keys, added_keys, in_keys, [=](JackknifeAnalyzer& rebinned) {
+		rebinned.add_fourier_transform(re_out_keys, im_out_keys, re_in_keys, im_in_keys, extents, sign);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_folded_correlator(const std::vector<K>& folded_keys,
+		const std::vector<K>& correlator_keys, T parity) {
+	const correlator::linear_terms<T> terms = correlator::folding_terms(correlator_keys.size(), parity);
+	if (folded_keys.size() != terms.size())
+		throw std::runtime_error("trying to fold a correlator with wrong number of keys.");
+
+	const std::vector<K> added_keys = new_keys(folded_keys);
+	if (added_keys.empty())
+		return;
+
+	add_linear_terms(folded_keys, terms, correlator_keys);
+	record_derivation(folded_keys, added_keys, correlator_keys, [=](JackknifeAnalyzer& rebinned) {
+		rebinned.add_folded_correlator(folded_keys, correlator_keys, parity);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_averaged_correlator(const std::vector<K>& average_keys,
+		const std::vector<std::vector<K> >& correlator_keys, const std::vector<std::size_t>& shifts) {
+	std::vector<K> in_keys;
+	for (const std::vector<K>& keys : correlator_keys) {
+		if (keys.size() != average_keys.size())
+			throw std::runtime_error("trying to average correlators with different numbers of time slices.");
+		in_keys.insert(in_keys.end(), keys.begin(), keys.end());
+	}
+
+	const correlator::linear_terms<T> terms = correlator::averaging_terms<T>(correlator_keys.size(),
+			average_keys.size(), shifts);
+
+	const std::vector<K> added_keys = new_keys(average_keys);
+	if (added_keys.empty())
+		return;
+
+	add_linear_terms(average_keys, terms, in_keys);
+	record_derivation(average_keys, added_keys, in_keys, [=](JackknifeAnalyzer& rebinned) {
+		rebinned.add_averaged_correlator(average_keys, correlator_keys, shifts);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::remove(const K& Xkey) {
 	Xs_mu.erase(Xkey);
-	Xs_reduced_samples.erase(Xkey);
+	Xs_sigma.erase(Xkey);
+	Xs_bias.erase(Xkey);
+	Xs_num_samples.erase(Xkey);
+	if (Xs_raw->count(Xkey))
+		unshared(Xs_raw).erase(Xkey);
+	Xs_bin_prefix_sums.erase(Xkey);
+	Xs_replica_lengths.erase(Xkey);
+	Xs_invalid_bins.erase(Xkey);
+	spilled_extents.erase(Xkey);
+
+	const auto slot = Xs_slot.find(Xkey);
+	if (slot != Xs_slot.end()) {
+		sample_store.release(slot->second);
+		Xs_slot.erase(slot);
+	}
+
+	lru.erase(Xkey);
+
+	Xs_derivation.erase(Xkey);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::compact() {
+	const std::vector<std::size_t> new_slots = sample_store.compact();
+
+	std::map<K, std::size_t> compacted_slots;
+	for (const auto& key_slot : Xs_slot)
+		compacted_slots.emplace_hint(compacted_slots.end(), key_slot.first, new_slots[key_slot.second]);
+	Xs_slot.swap(compacted_slots);
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::is_valid(const K& Xkey) const {
+	return Xs_invalid_bins.count(Xkey) == 0;
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<std::size_t> JackknifeAnalyzer<K, T, Layout>::invalid_bins(const K& Xkey) const {
+	const auto invalid = Xs_invalid_bins.find(Xkey);
+	return invalid == Xs_invalid_bins.end() ? std::vector<std::size_t> { } : invalid->second;
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<K> JackknifeAnalyzer<K, T, Layout>::invalid_keys() const {
+	std::vector<K> keys;
+	for (const auto& key_bins : Xs_invalid_bins)
+		keys.push_back(key_bins.first);
+	return keys;
 }
 
-template<typename K, typename T>
-std::vector<K> JackknifeAnalyzer<K, T>::keys() const {
+template<typename K, typename T, typename Layout>
+std::size_t JackknifeAnalyzer<K, T, Layout>::num_bins() const {
+	return N_bins;
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<K> JackknifeAnalyzer<K, T, Layout>::keys() const {
 	std::vector<K> ks;
 	for (const auto& key_mu : Xs_mu)
 		ks.push_back(key_mu.first);
 	return ks;
 }
 
-template<typename K, typename T>
-T JackknifeAnalyzer<K, T>::mu(const K& Xkey) const {
+template<typename K, typename T, typename Layout>
+typename JackknifeAnalyzer<K, T, Layout>::key_range JackknifeAnalyzer<K, T, Layout>::key_view() const {
+	return key_range { Xs_mu.begin(), Xs_mu.end() };
+}
+
+template<typename K, typename T, typename Layout>
+typename JackknifeAnalyzer<K, T, Layout>::key_range JackknifeAnalyzer<K, T, Layout>::key_view(const K& first, const K& last) const {
+	if (last < first)
+		return key_range { Xs_mu.end(), Xs_mu.end() };
+	return key_range { Xs_mu.lower_bound(first), Xs_mu.lower_bound(last) };
+}
+
+template<typename K, typename T, typename Layout>
+template<typename P>
+typename JackknifeAnalyzer<K, T, Layout>::key_range JackknifeAnalyzer<K, T, Layout>::keys_with_prefix(const P& prefix) const {
+#if __cplusplus >= 201402L
+	const auto range = Xs_mu.equal_range(key_prefix<P> { prefix });
+	return key_range { range.first, range.second };
+#else // std::map has no heterogeneous lookup before C++14, so the keys with prefix are found from the smallest one
+	const auto first = prefix_lower_bound(Xs_mu, prefix);
+	auto last = first;
+	while (last != Xs_mu.end() && compare_prefix(last->first, prefix) == 0)
+		++last;
+	return key_range { first, last };
+#endif
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<K> JackknifeAnalyzer<K, T, Layout>::keys_matching(const K& pattern) const {
+	const auto wildcard_pos = pattern.find_first_of("*?");
+	const K literal_prefix = pattern.substr(0, wildcard_pos);
+
+	// a mismatch only backtracks to the last '*', which then matches one more character, as earlier '*' could only
+	// match what the last one can, so matching takes at most pattern.size() * key.size() steps
+	const auto matches = [&pattern](std::size_t p, const K& key, std::size_t k) {
+		std::size_t last_star = K::npos, last_star_k = 0;
+		while (k < key.size()) {
+			if (p < pattern.size() && pattern[p] == '*') {
+				last_star = p++;
+				last_star_k = k;
+			} else if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == key[k])) {
+				++p;
+				++k;
+			} else if (last_star != K::npos) {
+				p = last_star + 1;
+				k = ++last_star_k;
+			} else
+				return false;
+		}
+		while (p < pattern.size() && pattern[p] == '*')
+			++p;
+		return p == pattern.size();
+	};
+
+	std::vector<K> ks;
+	for (const K& key : keys_with_prefix(literal_prefix))
+		if (matches(literal_prefix.size(), key, literal_prefix.size()))
+			ks.push_back(key);
+	return ks;
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout> JackknifeAnalyzer<K, T, Layout>::rebin(std::size_t factor) const {
+	if (factor == 0 || N_bins / factor < 2)
+		throw std::runtime_error("trying to rebin to less than 2 bins.");
+
+	JackknifeAnalyzer<K, T, Layout> rebinned { bin_size * factor };
+	rebinned.set_reduction_mode(reductions);
+	rebinned.memory_budget = memory_budget;
+	rebinned.scratch = scratch;
+
+	const std::size_t N_rebinned = N_bins / factor;
+	for (const auto& key_num_samples : Xs_num_samples) {
+		const K& key = key_num_samples.first;
+		const std::size_t num_samples = key_num_samples.second;
+		const T sum_samples = Xs_mu.at(key) * static_cast<T>(num_samples);
+		const std::vector<T> X_samples = samples(key);
+
+		// bin sums are recovered from the jackknife samples X_b = (sum_samples - bin_sum_b) / (num_samples - bin_size)
+		const auto replica_lengths = Xs_replica_lengths.find(key);
+		if (replica_lengths == Xs_replica_lengths.end()) {
+			std::vector<T> bin_sums(N_rebinned, 0);
+			for (std::size_t b = 0; b < N_rebinned * factor; ++b)
+				bin_sums[b / factor] += sum_samples - static_cast<T>(num_samples - bin_size) * X_samples[b];
+			rebinned.add_bin_sums(key, bin_sums, sum_samples, num_samples);
+		} else { // bins are merged within each replica only
+			std::vector<T> bin_sums;
+			std::size_t first_bin = 0;
+			for (const std::size_t replica_length : replica_lengths->second) {
+				const std::size_t replica_bins = replica_length / bin_size;
+				for (std::size_t b = 0; b < replica_bins / factor * factor; ++b) {
+					if (b % factor == 0)
+						bin_sums.push_back(0);
+					bin_sums.back() += sum_samples - static_cast<T>(num_samples - bin_size) * X_samples[first_bin + b];
+				}
+				first_bin += replica_bins;
+			}
+			rebinned.add_bin_sums(key, bin_sums, sum_samples, num_samples);
+			rebinned.Xs_replica_lengths.insert(*replica_lengths);
+		}
+	}
+
+	rederive(rebinned);
+	return rebinned;
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout> JackknifeAnalyzer<K, T, Layout>::reanalyze(std::size_t new_bin_size, std::size_t first,
+		std::size_t last) const {
+	JackknifeAnalyzer<K, T, Layout> reanalyzed { new_bin_size };
+	reanalyzed.retain_raw_histories(retain_raw, raw_retention_encoding);
+	reanalyzed.set_reduction_mode(reductions);
+	reanalyzed.memory_budget = memory_budget;
+	reanalyzed.scratch = scratch;
+
+	for (const auto& key_num_samples : Xs_num_samples) {
+		const auto raw = Xs_raw->find(key_num_samples.first);
+		if (raw == Xs_raw->end())
+			throw std::runtime_error("trying to reanalyze a variable without raw history.");
+
+		const auto replica_lengths = Xs_replica_lengths.find(key_num_samples.first);
+		if (replica_lengths == Xs_replica_lengths.end()) {
+			const std::size_t cut_last = std::min(last, raw->second->size());
+			if (first >= cut_last)
+				throw std::runtime_error("trying to reanalyze an empty range of samples.");
+
+			std::vector<T> cut_samples(cut_last - first);
+			raw->second->decode(first, cut_last, cut_samples.data());
+			reanalyzed.resample(key_num_samples.first, cut_samples);
+		} else { // the range is applied to each replica
+			std::vector<std::vector<T> > cut_replicas;
+			std::size_t replica_first = 0;
+			for (const std::size_t replica_length : replica_lengths->second) {
+				const std::size_t cut_last = std::min(last, replica_length);
+				if (first >= cut_last)
+					throw std::runtime_error("trying to reanalyze an empty range of samples.");
+
+				cut_replicas.emplace_back(cut_last - first);
+				raw->second->decode(replica_first + first, replica_first + cut_last, cut_replicas.back().data());
+				replica_first += replica_length;
+			}
+			reanalyzed.resample_replicas(key_num_samples.first, cut_replicas);
+		}
+	}
+
+	rederive(reanalyzed);
+	return reanalyzed;
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::retain_raw_histories(bool retain, raw_encoding encoding) {
+	retain_raw = retain;
+	raw_retention_encoding = encoding;
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::set_reduction_mode(reduction_mode mode) {
+	reductions = mode;
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::jackknife_range(const K& Xkey, std::size_t first_bin, std::size_t last_bin, T& mu_X,
+		T& sigma_X) const {
+	const auto prefix_sums = Xs_bin_prefix_sums.find(Xkey);
+	if (prefix_sums == Xs_bin_prefix_sums.end())
+		return false;
+	if (first_bin > last_bin || last_bin > N_bins || last_bin - first_bin < 2)
+		throw std::runtime_error("trying to compute jackknife of less than 2 bins or bins out of range.");
+
+	// with M bins of sums B_b and n = M * bin_size samples, the jackknife samples (S - B_b) / (n - bin_size)
+	// average to the mean S / n, and their squared deviations sum to (sum_b B_b^2 - S^2 / M) / (n - bin_size)^2
+	const std::size_t num_bins = last_bin - first_bin, num_samples = num_bins * bin_size;
+	const prefix_sum shifted_sum = prefix_sums->second->sums[last_bin] - prefix_sums->second->sums[first_bin];
+	const prefix_sum shifted_squares = prefix_sums->second->squares[last_bin]
+			- prefix_sums->second->squares[first_bin];
+
+	mu_X = (T) ((shifted_sum + static_cast<prefix_sum>(num_bins) * prefix_sums->second->shift)
+			/ static_cast<prefix_sum>(num_samples));
+
+	const prefix_sum squared_deviations = std::max((prefix_sum) 0,
+			shifted_squares - shifted_sum * shifted_sum / static_cast<prefix_sum>(num_bins))
+			/ pow(static_cast<prefix_sum>(num_samples - bin_size), 2);
+	sigma_X = (T) sqrt((((prefix_sum) (num_bins - 1)) / ((prefix_sum) num_bins)) * squared_deviations);
+	return true;
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<T> JackknifeAnalyzer<K, T, Layout>::raw_history(const K& Xkey) const {
+	return Xs_raw->at(Xkey)->decode();
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout> JackknifeAnalyzer<K, T, Layout>::snapshot() const {
+	return *this;
+}
+
+template<typename K, typename T, typename Layout>
+T JackknifeAnalyzer<K, T, Layout>::mu(const K& Xkey) const {
 	return Xs_mu.at(Xkey);
 }
 
-template<typename K, typename T>
-T JackknifeAnalyzer<K, T>::sigma(const K& Xkey) const {
-	double sigma = 0.0;
-	for (const T& d : Xs_reduced_samples.at(Xkey))
-		sigma += pow(d - Xs_mu.at(Xkey), (T) 2);
-	return sqrt((((T) (N_bins - 1)) / ((T) N_bins)) * sigma);
+template<typename K, typename T, typename Layout>
+T JackknifeAnalyzer<K, T, Layout>::sigma(const K& Xkey) const {
+	if (Xs_slot.count(Xkey) == 0)
+		return Xs_sigma.at(Xkey);
+	if (memory_budget > 0)
+		touch(Xkey);
+	gather_buffer gathered;
+	return jackknife_sigma(resident_samples(Xkey, gathered), Xs_mu.at(Xkey));
 }
 
-template<typename K, typename T>
-bool JackknifeAnalyzer<K, T>::jackknife(const K& Xkey, T& mu_X, T& sigma_X) const {
-	if (Xs_reduced_samples.count(Xkey) && Xs_mu.count(Xkey)) {
-		mu_X = Xs_mu.at(Xkey);
+template<typename K, typename T, typename Layout>
+std::vector<T> JackknifeAnalyzer<K, T, Layout>::sigmas(const std::vector<K>& Xkeys) const {
+	constexpr std::size_t L = Layout::lanes;
+	std::vector<T> Xs_sigmas(Xkeys.size());
+
+	// requested keys by tile, i.e. by slot / L
+	std::map<std::size_t, std::vector<std::size_t> > tile_requests;
+	for (std::size_t k = 0; k < Xkeys.size(); ++k) {
+		const auto slot = Xs_slot.find(Xkeys[k]);
+		if (L == 1 || slot == Xs_slot.end())
+			Xs_sigmas[k] = sigma(Xkeys[k]);
+		else
+			tile_requests[slot->second / L].push_back(k);
+	}
+
+	std::array<T, L> tile_mu;
+	for (const auto& tile_request : tile_requests) {
+		std::size_t lane;
+		const T* tile_samples = sample_store.tile_data(Xs_slot.at(Xkeys[tile_request.second.front()]), lane);
+		tile_mu.fill(0);
+		for (const std::size_t k : tile_request.second) {
+			sample_store.tile_data(Xs_slot.at(Xkeys[k]), lane);
+			tile_mu[lane] = Xs_mu.at(Xkeys[k]);
+			if (memory_budget > 0)
+				touch(Xkeys[k]);
+		}
+
+		// all lanes are reduced at once, including unused or unrequested ones, in the same order as by sigma(...)
+		const std::array<double, L> sum_squared_deviations = reduction::reduce(N_bins, std::array<double, L> { },
+				[&](std::array<double, L>& partial, std::size_t first, std::size_t last) {
+					for (std::size_t i = first; i < last; ++i) {
+						const T* bin_samples = tile_samples + i * L;
+#pragma omp simd
+						for (std::size_t l = 0; l < L; ++l) {
+							const T deviation = bin_samples[l] - tile_mu[l];
+							partial[l] += deviation * deviation;
+						}
+					}
+				}, [](std::array<double, L>& partial, const std::array<double, L>& other) {
+					for (std::size_t l = 0; l < L; ++l)
+						partial[l] += other[l];
+				}, reductions);
+
+		for (const std::size_t k : tile_request.second) {
+			sample_store.tile_data(Xs_slot.at(Xkeys[k]), lane);
+			Xs_sigmas[k] = sqrt((((T) (N_bins - 1)) / ((T) N_bins)) * sum_squared_deviations[lane]);
+		}
+	}
+	return Xs_sigmas;
+}
 
-		sigma_X = 0;
-		for (const T& d : Xs_reduced_samples.at(Xkey))
-			sigma_X += pow(d - mu_X, (T) 2);
-		sigma_X = sqrt((((T) (N_bins - 1)) / ((T) N_bins)) * sigma_X);
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::jackknife(const K& Xkey, T& mu_X, T& sigma_X) const {
+	if (Xs_mu.count(Xkey)) {
+		mu_X = Xs_mu.at(Xkey);
+		sigma_X = sigma(Xkey);
 		return true;
 	} else
 		return false;
 }
 
-template<typename K, typename T>
-std::vector<T> JackknifeAnalyzer<K, T>::samples(const K& Xkey) const {
-	return Xs_reduced_samples.at(Xkey);
+template<typename K, typename T, typename Layout>
+T JackknifeAnalyzer<K, T, Layout>::bias(const K& Xkey) const {
+	if (is_terminal(Xkey))
+		return Xs_bias.at(Xkey);
+
+	const T mu_X = Xs_mu.at(Xkey);
+	const std::vector<T> X_samples = samples(Xkey);
+	const T sum_deviations = reduction::sum<T>(N_bins, [&](std::size_t i) {
+		return X_samples[i] - mu_X;
+	}, reductions);
+	return ((T) (N_bins - 1)) / ((T) N_bins) * sum_deviations;
+}
+
+template<typename K, typename T, typename Layout>
+T JackknifeAnalyzer<K, T, Layout>::covariance(const K& Xkey, const K& Ykey) const {
+	const std::vector<T> X_samples = samples(Xkey), Y_samples = samples(Ykey);
+	const T mu_X = Xs_mu.at(Xkey), mu_Y = Xs_mu.at(Ykey);
+
+	const T sum = reduction::sum<T>(N_bins, [&](std::size_t i) {
+		return (X_samples[i] - mu_X) * (Y_samples[i] - mu_Y);
+	}, reductions);
+	return ((T) (N_bins - 1)) / ((T) N_bins) * sum;
+}
+
+template<typename K, typename T, typename Layout>
+CovarianceEstimate<T> JackknifeAnalyzer<K, T, Layout>::covariance_estimate(const std::vector<K>& Xkeys, T shrinkage,
+		T svd_cut) const {
+	std::vector<T> Xs_samples, Xs_means;
+	Xs_samples.reserve(Xkeys.size() * N_bins);
+	for (const K& key : Xkeys) {
+		const std::vector<T> X_samples = samples(key);
+		Xs_samples.insert(Xs_samples.end(), X_samples.begin(), X_samples.end());
+		Xs_means.push_back(Xs_mu.at(key));
+	}
+	return CovarianceEstimate<T>(Xs_samples, Xs_means, shrinkage, svd_cut);
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<T> JackknifeAnalyzer<K, T, Layout>::samples(const K& Xkey) const {
+	const auto slot = Xs_slot.find(Xkey);
+	if (slot != Xs_slot.end()) {
+		if (memory_budget > 0)
+			touch(Xkey);
+		std::vector<T> Xjackknife_samples(N_bins);
+		sample_store.read(slot->second, Xjackknife_samples.data());
+		return Xjackknife_samples;
+	}
+	if (is_spilled(Xkey))
+		return read_spilled(Xkey);
+	if (Xs_mu.count(Xkey))
+		throw std::runtime_error("trying to access samples of a terminal variable.");
+	throw std::out_of_range("JackknifeAnalyzer::samples key does not exist");
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::set_memory_budget(std::size_t max_bytes, const std::string& scratch_path) {
+	if (max_bytes > 0 && !scratch)
+		scratch = std::make_shared<scratch_space>(scratch_path);
+	else if (max_bytes > 0 && scratch->path != scratch_path)
+		throw std::runtime_error("trying to change the scratch file " + scratch->path + " to " + scratch_path);
+
+	memory_budget = max_bytes;
+	if (memory_budget == 0) {
+		lru.clear();
+		return;
+	}
+
+	for (const auto& key_slot : Xs_slot)
+		if (!lru.contains(key_slot.first))
+			lru.touch(key_slot.first);
+	enforce_memory_budget();
 }
 
 // ************************************** private **************************************
 
-template<typename K, typename T>
-bool JackknifeAnalyzer<K, T>::init_or_verify_N(const std::vector<T>& Xsamples, bool binned) {
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::init_or_verify_N(const std::vector<T>& Xsamples, bool binned) {
 	const auto num_bins = Xsamples.size() / (binned ? 1 : bin_size);
 
 	if (N_bins == 0) {
@@ -161,12 +1105,624 @@ bool JackknifeAnalyzer<K, T>::init_or_verify_N(const std::vector<T>& Xsamples, b
 			N_bins = num_bins;
 		else
 			throw std::runtime_error("trying to add dataset with less than 2 bins.");
+		sample_store = SampleStore<T, Layout>(N_bins);
 	} else if (num_bins != N_bins)
 		throw std::runtime_error("trying to add dataset with different number of bins than already existing ones.");
 
 	return true;
 }
 
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_bin_sums(const K& Xkey, const std::vector<T>& bin_sums, const T& sum_samples,
+		std::size_t num_samples) {
+	std::vector<T> reduced_sums(bin_sums.size());
+	for (std::size_t b = 0; b < bin_sums.size(); ++b)
+		reduced_sums[b] = sum_samples - bin_sums[b];
+	add_reduced_sums(Xkey, bin_sums, reduced_sums, sum_samples, num_samples);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_reduced_sums(const K& Xkey, const std::vector<T>& bin_sums,
+		const std::vector<T>& reduced_sums, const T& sum_samples, std::size_t num_samples) {
+	init_or_verify_N(bin_sums, true);
+
+	const T N_reduced = static_cast<T>(num_samples - bin_size);
+	store_samples(Xkey, sum_samples / static_cast<T>(num_samples), [&](T* red_samples) {
+		for (std::size_t b = 0; b < N_bins; ++b)
+			red_samples[b] = reduced_sums[b] / N_reduced;
+	});
+	Xs_num_samples[Xkey] = num_samples;
+
+	// a single invalid bin spoils all jackknife samples, so the bins of the input are reported instead
+	if (Xs_invalid_bins.count(Xkey)) {
+		std::vector<std::size_t>& invalid_bins = Xs_invalid_bins[Xkey];
+		invalid_bins.clear();
+		for (std::size_t b = 0; b < N_bins; ++b)
+			if (!std::isfinite(bin_sums[b]))
+				invalid_bins.push_back(b);
+	}
+}
+
+template<typename K, typename T, typename Layout>
+T JackknifeAnalyzer<K, T, Layout>::sum_into_bins(const T* samples, std::size_t num_samples, T* bin_sums,
+		T* reduced_sums) const {
+	// bin b starts at sample b * bin_size >= b and is read before bin_sums[b] is written, so bin_sums may be samples
+	if (reductions == reduction_mode::sequential) {
+		// the order of the plain loops: all samples are summed in order, then subtracted bin by bin
+		T sum_samples = 0;
+		for (std::size_t i = 0; i < num_samples; ++i)
+			sum_samples += samples[i];
+		for (std::size_t b = 0; b < N_bins; ++b) {
+			const T* bin = samples + b * bin_size;
+			T bin_sum = 0, reduced_sum = sum_samples;
+			for (std::size_t i = 0; i < bin_size; ++i) {
+				bin_sum += bin[i];
+				reduced_sum -= bin[i];
+			}
+			bin_sums[b] = bin_sum;
+			reduced_sums[b] = reduced_sum;
+		}
+		return sum_samples;
+	}
+
+	for (std::size_t b = 0; b < N_bins; ++b) {
+		const T* bin = samples + b * bin_size;
+		T bin_sum = 0;
+		for (std::size_t i = 0; i < bin_size; ++i)
+			bin_sum += bin[i];
+		bin_sums[b] = bin_sum;
+	}
+
+	T sum_samples = reduction::sum<T>(N_bins, [bin_sums](std::size_t b) {
+		return bin_sums[b];
+	}, reductions);
+	for (std::size_t i = N_bins * bin_size; i < num_samples; ++i)
+		sum_samples += samples[i];
+	for (std::size_t b = 0; b < N_bins; ++b)
+		reduced_sums[b] = sum_samples - bin_sums[b];
+	return sum_samples;
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::store_bin_prefix_sums(const K& Xkey, const std::vector<T>& bin_sums,
+		const T& sum_samples, std::size_t num_samples) {
+	// sums are shifted by the average bin sum to avoid cancellations in the squares
+	auto prefix_sums = std::make_shared<bin_prefix_sums>();
+	prefix_sums->shift = static_cast<prefix_sum>(sum_samples) / num_samples * bin_size;
+	prefix_sums->sums.assign(bin_sums.size() + 1, 0);
+	prefix_sums->squares.assign(bin_sums.size() + 1, 0);
+	for (std::size_t b = 0; b < bin_sums.size(); ++b) {
+		const prefix_sum shifted = bin_sums[b] - prefix_sums->shift;
+		prefix_sums->sums[b + 1] = prefix_sums->sums[b] + shifted;
+		prefix_sums->squares[b + 1] = prefix_sums->squares[b] + shifted * shifted;
+	}
+	Xs_bin_prefix_sums.emplace(Xkey, prefix_sums);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::rederive(JackknifeAnalyzer& target) const {
+	// When replayed in order, a derivation produces all its outputs which do not exist yet, so its arguments are
+	// those of the derivations it depended on when it was recorded, unless a later derivation replaces them.
+	std::map<std::size_t, const derivation*> replayed;
+	std::vector<const derivation*> pending;
+	for (const auto& key_derivation : Xs_derivation)
+		pending.push_back(key_derivation.second.get());
+	while (!pending.empty()) {
+		const derivation* recorded = pending.back();
+		pending.pop_back();
+		if (replayed.emplace(recorded->sequence, recorded).second)
+			for (const auto& dependency : recorded->dependencies)
+				pending.push_back(dependency.get());
+	}
+
+	for (const auto& sequence_derivation : replayed) {
+		const derivation* recorded = sequence_derivation.second;
+		// a variable which was removed and derived again still holds the value of its earlier derivation
+		for (const K& key : recorded->outputs)
+			if (is_derived_by(key, recorded) && target.Xs_mu.count(key))
+				target.remove(key);
+
+		try {
+			recorded->derive(target);
+		} catch (const std::out_of_range&) { // an argument was removed or cannot be reconstructed
+			for (const K& key : recorded->outputs)
+				if (is_derived_by(key, recorded))
+					throw std::runtime_error("trying to reconstruct a variable which depends on variables that cannot be reconstructed.");
+		}
+	}
+
+	std::vector<K> removed_keys;
+	for (const K& key : target.key_view())
+		if (Xs_mu.count(key) == 0)
+			removed_keys.push_back(key);
+	for (const K& key : removed_keys)
+		target.remove(key);
+	if (target.Xs_mu.size() != Xs_mu.size())
+		throw std::runtime_error("trying to reconstruct variables which were not added with resample(...).");
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::record_derivation(const std::vector<K>& Xkeys, const std::vector<K>& new_Xkeys,
+		const std::vector<K>& arg_keys, std::function<void(JackknifeAnalyzer&)> derive) {
+	std::vector<std::shared_ptr<const derivation> > dependencies;
+	for (const K& key : arg_keys) {
+		const auto latest = Xs_derivation.find(key);
+		if (latest != Xs_derivation.end()
+				&& std::find(dependencies.begin(), dependencies.end(), latest->second) == dependencies.end())
+			dependencies.push_back(latest->second);
+	}
+
+	// not allocated as const, so that ~derivation() may release the dependencies of unshared derivations
+	const std::shared_ptr<const derivation> recorded = std::make_shared<derivation>(Xkeys, std::move(dependencies),
+			num_recorded_derivations++, std::move(derive));
+	for (const K& key : new_Xkeys)
+		Xs_derivation[key] = recorded;
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::derivation::derivation(const std::vector<K>& outputs,
+		std::vector<std::shared_ptr<const derivation> > dependencies, std::size_t sequence,
+		std::function<void(JackknifeAnalyzer&)> derive) :
+		outputs { outputs }, dependencies { std::move(dependencies) }, sequence { sequence }, derive { std::move(derive) } {
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::derivation::~derivation() {
+	// releases long chains of derivations iteratively instead of recursively
+	std::vector<std::shared_ptr<const derivation> > released = std::move(dependencies);
+	while (!released.empty()) {
+		std::shared_ptr<const derivation> last = std::move(released.back());
+		released.pop_back();
+		if (last.use_count() == 1) {
+			auto& last_dependencies = const_cast<derivation&>(*last).dependencies;
+			std::move(last_dependencies.begin(), last_dependencies.end(), std::back_inserter(released));
+			last_dependencies.clear();
+		}
+	}
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::scratch_space::scratch_space(const std::string& path) :
+		path { path }, file { path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc } {
+	if (!file)
+		throw std::runtime_error("could not open scratch file " + path);
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::scratch_space::~scratch_space() {
+	file.close();
+	std::remove(path.c_str());
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::spilled_extent::spilled_extent(std::shared_ptr<scratch_space> scratch,
+		std::streamoff offset, std::size_t bytes) :
+		scratch { std::move(scratch) }, offset { offset }, bytes { bytes } {
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::spilled_extent::~spilled_extent() {
+	std::lock_guard<std::mutex> lock(scratch->mutex);
+	scratch->free_extents[bytes].push_back(offset);
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::is_derived_by(const K& Xkey, const derivation* recorded) const {
+	const auto latest = Xs_derivation.find(Xkey);
+	return latest != Xs_derivation.end() && latest->second.get() == recorded;
+}
+
+template<typename K, typename T, typename Layout>
+template<typename U>
+U& JackknifeAnalyzer<K, T, Layout>::unshared(std::shared_ptr<U>& shared) {
+	if (shared.use_count() > 1) // the other owners are copies, which cannot be made while this one is changed
+		shared = std::make_shared<U>(*shared);
+	else // pairs with the release decrement of a copy dropped in another thread, see SampleStore::mutable_data(...)
+		std::atomic_thread_fence(std::memory_order_acquire);
+	return *shared;
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<K> JackknifeAnalyzer<K, T, Layout>::new_keys(const std::vector<K>& Xkeys) const {
+	std::vector<K> Xkeys_new;
+	for (const K& key : Xkeys)
+		if (Xs_mu.count(key) == 0 && std::find(Xkeys_new.begin(), Xkeys_new.end(), key) == Xkeys_new.end())
+			Xkeys_new.push_back(key);
+	return Xkeys_new;
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::is_terminal(const K& Xkey) const {
+	return Xs_mu.count(Xkey) && Xs_slot.count(Xkey) == 0 && spilled_extents.count(Xkey) == 0;
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::is_spilled(const K& Xkey) const {
+	return Xs_slot.count(Xkey) == 0 && spilled_extents.count(Xkey);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::store_summary(const K& Fkey, const T& F_mu, const T& sum_deviations,
+		const double& sum_squared_deviations) {
+	Xs_mu[Fkey] = F_mu;
+	Xs_sigma[Fkey] = sqrt((((T) (N_bins - 1)) / ((T) N_bins)) * sum_squared_deviations);
+	Xs_bias[Fkey] = ((T) (N_bins - 1)) / ((T) N_bins) * sum_deviations;
+	if (!all_finite(&F_mu, 1) || !all_finite(&Xs_sigma[Fkey], 1)) // bins of terminal variables are unknown
+		Xs_invalid_bins[Fkey];
+	if (memory_budget > 0) // the arguments may have been paged in
+		enforce_memory_budget();
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Deviation>
+void JackknifeAnalyzer<K, T, Layout>::store_summary(const K& Fkey, const T& F_mu, Deviation deviation) {
+	// deviation(i) is evaluated once per bin and only by this thread, in the order of bias(...) and sigma(...)
+	using sums = std::pair<T, double>;
+	const sums totals = reduction::reduce(N_bins, sums { 0, 0 },
+			[&deviation](sums& partial, std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i < last; ++i) {
+					const T d = deviation(i);
+					partial.first += d;
+					partial.second += d * d;
+				}
+			}, [](sums& partial, const sums& other) {
+				partial.first += other.first;
+				partial.second += other.second;
+			}, reductions, false);
+	store_summary(Fkey, F_mu, totals.first, totals.second);
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::all_finite(const T* values, std::size_t n) {
+	// x * 0 is NaN exactly if x is NaN or infinite
+	T probe = 0;
+#pragma omp simd reduction(+:probe)
+	for (std::size_t i = 0; i < n; ++i)
+		probe += values[i] * 0;
+	return probe == probe;
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::validate(const K& Xkey, const T* Xjackknife_samples, const T& mu_X) {
+	if (all_finite(Xjackknife_samples, N_bins) && all_finite(&mu_X, 1))
+		return;
+
+	std::vector<std::size_t>& invalid_bins = Xs_invalid_bins[Xkey];
+	for (std::size_t b = 0; b < N_bins; ++b)
+		if (!std::isfinite(Xjackknife_samples[b]))
+			invalid_bins.push_back(b);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::page_in(const K& Xkey) {
+	if (Xs_slot.count(Xkey) == 0) {
+		if (!is_spilled(Xkey))
+			throw std::out_of_range("JackknifeAnalyzer: no samples for key");
+
+		const std::size_t new_slot = sample_store.allocate();
+		try {
+			if (sample_store.stride() == 1)
+				read_spilled(Xkey, sample_store.mutable_data(new_slot));
+			else
+				sample_store.write(new_slot, read_spilled(Xkey).data());
+		} catch (...) {
+			sample_store.release(new_slot);
+			throw;
+		}
+		Xs_slot[Xkey] = new_slot;
+	}
+	if (memory_budget > 0)
+		touch(Xkey);
+}
+
+template<typename K, typename T, typename Layout>
+const T* JackknifeAnalyzer<K, T, Layout>::resident_samples(const K& Xkey, gather_buffer& gathered) const {
+	const std::size_t slot = Xs_slot.at(Xkey);
+	if (sample_store.stride() == 1)
+		return sample_store.data(slot);
+
+	gathered.emplace_back(N_bins);
+	sample_store.read(slot, gathered.back().data());
+	return gathered.back().data();
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<T> JackknifeAnalyzer<K, T, Layout>::read_spilled(const K& Xkey) const {
+	std::vector<T> Xjackknife_samples(N_bins);
+	read_spilled(Xkey, Xjackknife_samples.data());
+	return Xjackknife_samples;
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::read_spilled(const K& Xkey, T* Xjackknife_samples) const {
+	const std::streamoff offset = spilled_extents.at(Xkey)->offset;
+	std::lock_guard<std::mutex> lock(scratch->mutex);
+	scratch->file.clear();
+	scratch->file.seekg(offset);
+	scratch->file.read(reinterpret_cast<char*>(Xjackknife_samples), N_bins * sizeof(T));
+	if (!scratch->file)
+		throw std::runtime_error("could not read spilled samples from scratch file.");
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Fill>
+void JackknifeAnalyzer<K, T, Layout>::store_samples(const K& Xkey, const T& mu_X, Fill fill_samples) {
+	const std::size_t slot = sample_store.allocate();
+	try {
+		if (sample_store.stride() == 1)
+			fill_samples(sample_store.mutable_data(slot));
+		else {
+			std::vector<T> staged_samples(N_bins);
+			fill_samples(staged_samples.data());
+			sample_store.write(slot, staged_samples.data());
+		}
+	} catch (...) {
+		sample_store.release(slot);
+		throw;
+	}
+
+	Xs_mu[Xkey] = mu_X;
+	Xs_slot[Xkey] = slot;
+	gather_buffer gathered;
+	validate(Xkey, resident_samples(Xkey, gathered), mu_X);
+	if (memory_budget > 0) {
+		touch(Xkey);
+		enforce_memory_budget();
+	}
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Fill>
+void JackknifeAnalyzer<K, T, Layout>::store_samples(const std::vector<K>& Xkeys, Fill fill_samples) {
+	std::vector<std::size_t> slots;
+	std::set<K> new_keys;
+	for (const K& key : Xkeys)
+		if (Xs_mu.count(key) == 0 && new_keys.insert(key).second)
+			slots.push_back(sample_store.allocate());
+
+	std::vector<T*> Xs_samples;
+	std::vector<T> Xs_mu_new(Xkeys.size());
+	std::vector<std::vector<T> > discarded_samples; // for keys which already exist
+	std::vector<std::vector<T> > staged_samples; // for new keys if slots are not contiguous
+	try {
+		auto slot = slots.begin();
+		std::set<K> assigned_keys;
+		for (const K& key : Xkeys)
+			if (new_keys.count(key) && assigned_keys.insert(key).second) {
+				if (sample_store.stride() == 1)
+					Xs_samples.push_back(sample_store.mutable_data(*slot++));
+				else {
+					staged_samples.emplace_back(N_bins);
+					Xs_samples.push_back(staged_samples.back().data());
+				}
+			} else {
+				discarded_samples.emplace_back(N_bins);
+				Xs_samples.push_back(discarded_samples.back().data());
+			}
+
+		fill_samples(Xs_samples, Xs_mu_new);
+		for (std::size_t k = 0; k < staged_samples.size(); ++k)
+			sample_store.write(slots[k], staged_samples[k].data());
+	} catch (...) {
+		for (const std::size_t slot : slots)
+			sample_store.release(slot);
+		throw;
+	}
+
+	auto slot = slots.begin();
+	gather_buffer gathered;
+	for (std::size_t k = 0; k < Xkeys.size(); ++k)
+		if (new_keys.erase(Xkeys[k])) {
+			Xs_mu[Xkeys[k]] = Xs_mu_new[k];
+			Xs_slot[Xkeys[k]] = *slot++;
+			validate(Xkeys[k], resident_samples(Xkeys[k], gathered), Xs_mu_new[k]);
+			if (memory_budget > 0)
+				touch(Xkeys[k]);
+		}
+	if (memory_budget > 0)
+		enforce_memory_budget();
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_fit_window_scan(const std::vector<K>& parameter_keys, const std::vector<K>& y_keys,
+		const FitWindowAverage<T>& windows) {
+	if (parameter_keys.size() != windows.num_parameters())
+		throw std::runtime_error("trying to fit with different numbers of parameter keys and basis functions.");
+
+	for (const K& key : y_keys)
+		page_in(key);
+
+	store_samples(parameter_keys, [&](const std::vector<T*>& P_samples, std::vector<T>& P_mu) {
+		const std::size_t N_points = y_keys.size(), N_params = parameter_keys.size();
+		gather_buffer gathered;
+		std::vector<const T*> y_samples;
+		std::vector<T> y(N_points);
+		for (std::size_t t = 0; t < N_points; ++t) {
+			y_samples.push_back(resident_samples(y_keys[t], gathered));
+			y[t] = Xs_mu.at(y_keys[t]);
+		}
+		windows.average(y.data(), P_mu.data());
+
+#pragma omp parallel
+		{
+			std::vector<T> y(N_points), params(N_params);
+#pragma omp for
+			for (std::size_t i = 0; i < N_bins; ++i) {
+				for (std::size_t t = 0; t < N_points; ++t)
+					y[t] = y_samples[t][i];
+				windows.average(y.data(), params.data());
+				for (std::size_t j = 0; j < N_params; ++j)
+					P_samples[j][i] = params[j];
+			}
+		}
+	});
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::add_linear_terms(const std::vector<K>& out_keys, const correlator::linear_terms<T>& terms,
+		const std::vector<K>& in_keys) {
+	if (out_keys.size() != terms.size())
+		throw std::runtime_error("trying to store a linear map with wrong number of keys.");
+
+	for (const K& key : in_keys)
+		page_in(key);
+
+	store_samples(out_keys, [&](const std::vector<T*>& out_samples, std::vector<T>& out_mu) {
+		gather_buffer gathered;
+		std::vector<const T*> in_samples, in_mu;
+		for (const K& key : in_keys) {
+			in_samples.push_back(resident_samples(key, gathered));
+			in_mu.push_back(&Xs_mu.at(key));
+		}
+		std::vector<T*> out_mu_pointers;
+		for (T& mu : out_mu)
+			out_mu_pointers.push_back(&mu);
+
+		correlator::apply_linear_terms(terms, in_samples, N_bins, out_samples);
+		correlator::apply_linear_terms(terms, in_mu, 1, out_mu_pointers);
+	});
+}
+
+template<typename K, typename T, typename Layout>
+std::vector<T> JackknifeAnalyzer<K, T, Layout>::basis_values(const std::vector<std::function<T(std::size_t)> >& basis,
+		std::size_t num_points) {
+	std::vector<T> model(num_points * basis.size());
+	for (std::size_t t = 0; t < num_points; ++t)
+		for (std::size_t j = 0; j < basis.size(); ++j)
+			model[t * basis.size() + j] = basis[j](t);
+	return model;
+}
+
+template<typename K, typename T, typename Layout>
+template<typename Function, std::size_t ... I>
+T JackknifeAnalyzer<K, T, Layout>::call_on_bin(Function& F, const std::array<const T*, sizeof...(I)>& args_samples,
+		std::size_t i, index_sequence<I...>) {
+	return F(args_samples[I][i]...);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::touch(const K& Xkey) const {
+	lru.touch(Xkey);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::spill(const K& Xkey) {
+	const std::size_t slot = Xs_slot.at(Xkey);
+	gather_buffer gathered;
+	const T* Xjackknife_samples = resident_samples(Xkey, gathered);
+
+	if (spilled_extents.count(Xkey) == 0) { // samples never change, so a key is written at most once
+		Xs_sigma[Xkey] = jackknife_sigma(Xjackknife_samples, Xs_mu.at(Xkey));
+
+		const std::size_t bytes = N_bins * sizeof(T);
+		std::lock_guard<std::mutex> lock(scratch->mutex);
+		scratch->file.clear();
+		std::vector<std::streamoff>& free_offsets = scratch->free_extents[bytes];
+		if (free_offsets.empty())
+			scratch->file.seekp(0, std::ios::end);
+		else
+			scratch->file.seekp(free_offsets.back());
+		const std::streamoff offset = scratch->file.tellp();
+		scratch->file.write(reinterpret_cast<const char*>(Xjackknife_samples), bytes);
+		scratch->file.flush();
+		if (!scratch->file)
+			throw std::runtime_error("could not write samples to scratch file.");
+		if (!free_offsets.empty())
+			free_offsets.pop_back();
+		spilled_extents[Xkey] = std::make_shared<const spilled_extent>(scratch, offset, bytes);
+	}
+
+	sample_store.release(slot);
+	Xs_slot.erase(Xkey);
+	lru.erase(Xkey);
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::enforce_memory_budget() {
+	while (lru.size() > 1 && lru.size() * N_bins * sizeof(T) > memory_budget)
+		spill(lru.least_recent());
+
+	// pages are freed once all their slots are spilled, holes in partially used pages only by compacting
+	const std::size_t unused_slots = sample_store.capacity() - sample_store.size();
+	if (unused_slots >= std::max(sample_store.size(), sample_store.page_size()))
+		compact();
+}
+
+template<typename K, typename T, typename Layout>
+JackknifeAnalyzer<K, T, Layout>::lru_order::lru_order(const lru_order& other) {
+	std::lock_guard<std::mutex> lock(other.mutex);
+	keys = other.keys;
+	for (auto pos = keys.begin(); pos != keys.end(); ++pos) // the positions of other point into its own list
+		positions.emplace(*pos, pos);
+}
+
+template<typename K, typename T, typename Layout>
+typename JackknifeAnalyzer<K, T, Layout>::lru_order& JackknifeAnalyzer<K, T, Layout>::lru_order::operator=(
+		const lru_order& other) {
+	if (this != &other) {
+		lru_order copy(other);
+		std::lock_guard<std::mutex> lock(mutex);
+		keys.swap(copy.keys); // swapping keeps the iterators of copy.positions valid
+		positions.swap(copy.positions);
+	}
+	return *this;
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::lru_order::touch(const K& Xkey) {
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto pos = positions.find(Xkey);
+	if (pos != positions.end())
+		keys.splice(keys.begin(), keys, pos->second);
+	else {
+		keys.push_front(Xkey);
+		positions[Xkey] = keys.begin();
+	}
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::lru_order::erase(const K& Xkey) {
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto pos = positions.find(Xkey);
+	if (pos != positions.end()) {
+		keys.erase(pos->second);
+		positions.erase(pos);
+	}
+}
+
+template<typename K, typename T, typename Layout>
+void JackknifeAnalyzer<K, T, Layout>::lru_order::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	keys.clear();
+	positions.clear();
+}
+
+template<typename K, typename T, typename Layout>
+bool JackknifeAnalyzer<K, T, Layout>::lru_order::contains(const K& Xkey) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return positions.count(Xkey) > 0;
+}
+
+template<typename K, typename T, typename Layout>
+std::size_t JackknifeAnalyzer<K, T, Layout>::lru_order::size() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return keys.size();
+}
+
+template<typename K, typename T, typename Layout>
+K JackknifeAnalyzer<K, T, Layout>::lru_order::least_recent() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return keys.back();
+}
+
+template<typename K, typename T, typename Layout>
+T JackknifeAnalyzer<K, T, Layout>::jackknife_sigma(const T* Xjackknife_samples, const T& mu_X) const {
+	const double sigma = reduction::sum<double>(N_bins, [&](std::size_t i) {
+		return pow(Xjackknife_samples[i] - mu_X, (T) 2);
+	}, reductions);
+	return sqrt((((T) (N_bins - 1)) / ((T) N_bins)) * sigma);
+}
+
 }
 }
 }
@@ -0,0 +1,132 @@
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+#include <LinearAlgebra.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+namespace linear_algebra {
+
+template<typename T>
+void cholesky_decompose(T* matrix, std::size_t n) {
+	for (std::size_t j = 0; j < n; ++j) {
+		T diag = matrix[j * n + j];
+		for (std::size_t k = 0; k < j; ++k)
+			diag -= matrix[j * n + k] * matrix[j * n + k];
+		if (!(diag > 0))
+			throw std::runtime_error("trying to decompose a matrix which is not positive definite.");
+		diag = sqrt(diag);
+		matrix[j * n + j] = diag;
+
+		for (std::size_t i = j + 1; i < n; ++i) {
+			T offdiag = matrix[i * n + j];
+			for (std::size_t k = 0; k < j; ++k)
+				offdiag -= matrix[i * n + k] * matrix[j * n + k];
+			matrix[i * n + j] = offdiag / diag;
+		}
+	}
+}
+
+template<typename T>
+void forward_substitute(const T* factor, std::size_t n, T* rhs) {
+	for (std::size_t i = 0; i < n; ++i) {
+		for (std::size_t k = 0; k < i; ++k)
+			rhs[i] -= factor[i * n + k] * rhs[k];
+		rhs[i] /= factor[i * n + i];
+	}
+}
+
+template<typename T>
+void cholesky_solve(const T* factor, std::size_t n, T* rhs) {
+	forward_substitute(factor, n, rhs);
+	for (std::size_t i = n; i-- > 0;) {
+		for (std::size_t k = i + 1; k < n; ++k)
+			rhs[i] -= factor[k * n + i] * rhs[k];
+		rhs[i] /= factor[i * n + i];
+	}
+}
+
+template<typename T>
+void symmetric_eigensystem(const std::vector<T>& matrix, std::size_t n, std::vector<T>& eigenvalues,
+		std::vector<T>& eigenvectors) {
+	std::vector<T> a(matrix);
+	eigenvectors.assign(n * n, 0);
+	for (std::size_t i = 0; i < n; ++i)
+		eigenvectors[i * n + i] = 1;
+
+	for (int sweep = 0; sweep < 100; ++sweep) {
+		T offdiag_norm = 0;
+		for (std::size_t p = 0; p < n; ++p)
+			for (std::size_t q = p + 1; q < n; ++q)
+				offdiag_norm += a[p * n + q] * a[p * n + q];
+		if (offdiag_norm == 0)
+			break;
+
+		for (std::size_t p = 0; p < n; ++p)
+			for (std::size_t q = p + 1; q < n; ++q) {
+				if (a[p * n + q] == 0)
+					continue;
+
+				const T theta = (a[q * n + q] - a[p * n + p]) / (2 * a[p * n + q]);
+				const T t = (theta >= 0 ? 1 : -1) / (std::abs(theta) + sqrt(theta * theta + 1));
+				const T c = 1 / sqrt(t * t + 1), s = t * c;
+
+				for (std::size_t k = 0; k < n; ++k) {
+					const T a_kp = a[k * n + p], a_kq = a[k * n + q];
+					a[k * n + p] = c * a_kp - s * a_kq;
+					a[k * n + q] = s * a_kp + c * a_kq;
+				}
+				for (std::size_t k = 0; k < n; ++k) {
+					const T a_pk = a[p * n + k], a_qk = a[q * n + k];
+					a[p * n + k] = c * a_pk - s * a_qk;
+					a[q * n + k] = s * a_pk + c * a_qk;
+				}
+				for (std::size_t k = 0; k < n; ++k) {
+					const T v_kp = eigenvectors[k * n + p], v_kq = eigenvectors[k * n + q];
+					eigenvectors[k * n + p] = c * v_kp - s * v_kq;
+					eigenvectors[k * n + q] = s * v_kp + c * v_kq;
+				}
+			}
+	}
+
+	eigenvalues.resize(n);
+	for (std::size_t i = 0; i < n; ++i)
+		eigenvalues[i] = a[i * n + i];
+}
+
+template<typename T>
+void multiply_rows(const T* matrix, const std::vector<const T*>& inputs, std::size_t n, const std::vector<T*>& outputs) {
+	constexpr std::size_t value_block = 512, input_block = 32;
+	const std::size_t num_inputs = inputs.size(), num_outputs = outputs.size();
+
+#pragma omp parallel for schedule(static)
+	for (std::size_t first = 0; first < n; first += value_block) {
+		const std::size_t last = std::min(first + value_block, n);
+		for (std::size_t o = 0; o < num_outputs; ++o)
+			std::fill(outputs[o] + first, outputs[o] + last, (T) 0);
+
+		for (std::size_t k_first = 0; k_first < num_inputs; k_first += input_block) {
+			const std::size_t k_last = std::min(k_first + input_block, num_inputs);
+			for (std::size_t o = 0; o < num_outputs; ++o) {
+				T* out = outputs[o];
+				for (std::size_t k = k_first; k < k_last; ++k) {
+					const T coefficient = matrix[o * num_inputs + k];
+					if (coefficient == 0)
+						continue;
+					const T* in = inputs[k];
+#pragma omp simd
+					for (std::size_t i = first; i < last; ++i)
+						out[i] += coefficient * in[i];
+				}
+			}
+		}
+	}
+}
+
+}
+}
+}
+}
@@ -0,0 +1,189 @@
+#include <string>
+#include <sstream>
+#include <limits>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <QueryServer.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename K, typename T, typename Layout>
+constexpr int QueryServer<K, T, Layout>::send_timeout_ms;
+template<typename K, typename T, typename Layout>
+constexpr std::size_t QueryServer<K, T, Layout>::max_request_bytes;
+
+template<typename K, typename T, typename Layout>
+QueryServer<K, T, Layout>::QueryServer(const std::string& socket_path, std::function<std::string(const K&)> key_name) :
+		socket_path(socket_path), key_name(key_name), listen_fd { -1 }, stopping { false } {
+
+	sockaddr_un address { };
+	address.sun_family = AF_UNIX;
+	if (socket_path.size() >= sizeof(address.sun_path))
+		throw std::runtime_error("could not create socket, path too long: " + socket_path);
+	std::strcpy(address.sun_path, socket_path.c_str());
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd < 0)
+		throw std::runtime_error("could not create socket " + socket_path);
+	unlink(socket_path.c_str());
+	if (bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+			|| listen(listen_fd, 8) != 0) {
+		close(listen_fd);
+		unlink(socket_path.c_str());
+		throw std::runtime_error("could not create socket " + socket_path);
+	}
+
+	try {
+		server = std::thread([this]() {
+			serve();
+		});
+	} catch (...) { // the destructor does not run
+		close(listen_fd);
+		unlink(socket_path.c_str());
+		throw;
+	}
+}
+
+template<typename K, typename T, typename Layout>
+QueryServer<K, T, Layout>::~QueryServer() {
+	stopping = true;
+	server.join();
+	close(listen_fd);
+	unlink(socket_path.c_str());
+}
+
+template<typename K, typename T, typename Layout>
+void QueryServer<K, T, Layout>::publish(const JackknifeAnalyzer<K, T, Layout>& analyzer) {
+	auto state = std::make_shared<published_state>(published_state { analyzer.snapshot(), { } });
+	std::lock_guard<std::mutex> lock(published_mutex);
+	published.swap(state);
+	// the previous state is released after unlocking
+}
+
+// ************************************** private **************************************
+
+template<typename K, typename T, typename Layout>
+void QueryServer<K, T, Layout>::serve() {
+	// the listening socket and all clients are polled with a timeout to notice stopping,
+	// buffers[c] holds the incomplete request of the client polled at fds[c]
+	std::vector<pollfd> fds { { listen_fd, POLLIN, 0 } };
+	std::vector<std::string> buffers(1);
+	while (!stopping) {
+		if (poll(fds.data(), fds.size(), 100) <= 0)
+			continue;
+
+		for (std::size_t c = fds.size() - 1; c > 0; --c)
+			if (fds[c].revents != 0 && !serve_client(fds[c].fd, buffers[c])) {
+				close(fds[c].fd);
+				fds.erase(fds.begin() + c);
+				buffers.erase(buffers.begin() + c);
+			}
+
+		if (fds[0].revents & POLLIN) {
+			const int client_fd = accept(listen_fd, nullptr, nullptr);
+			if (client_fd >= 0) {
+				const timeval send_timeout { send_timeout_ms / 1000, send_timeout_ms % 1000 * 1000 };
+				setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+				fds.push_back( { client_fd, POLLIN, 0 });
+				buffers.emplace_back();
+			}
+		}
+	}
+
+	for (std::size_t c = 1; c < fds.size(); ++c)
+		close(fds[c].fd);
+}
+
+template<typename K, typename T, typename Layout>
+bool QueryServer<K, T, Layout>::serve_client(int client_fd, std::string& buffer) {
+	char chunk[4096];
+	const ssize_t received = read(client_fd, chunk, sizeof(chunk));
+	if (received <= 0)
+		return false;
+	buffer.append(chunk, received);
+
+	std::size_t line_end;
+	while ((line_end = buffer.find('\n')) != std::string::npos) {
+		const std::string response = answer(buffer.substr(0, line_end)) + "\n";
+		buffer.erase(0, line_end + 1);
+		for (std::size_t sent = 0; sent < response.size();) {
+			const ssize_t written = send(client_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+			if (written <= 0)
+				return false;
+			sent += written;
+		}
+	}
+	return buffer.size() <= max_request_bytes;
+}
+
+template<typename K, typename T, typename Layout>
+std::string QueryServer<K, T, Layout>::answer(const std::string& request) {
+	std::vector<std::string> fields;
+	std::istringstream request_stream(request);
+	for (std::string field; std::getline(request_stream, field, '\t');)
+		fields.push_back(field);
+	if (!fields.empty() && !fields.back().empty() && fields.back().back() == '\r')
+		fields.back().pop_back();
+
+	std::shared_ptr<published_state> state;
+	{
+		std::lock_guard<std::mutex> lock(published_mutex);
+		state = published;
+	}
+
+	std::ostringstream response;
+	response.precision(std::numeric_limits<T>::max_digits10);
+	try {
+		if (fields.empty())
+			throw std::runtime_error("empty request");
+		if (!state)
+			throw std::runtime_error("nothing published");
+
+		if (state->keys.empty())
+			for (const K& key : state->analyzer.key_view())
+				state->keys.emplace(key_name(key), key);
+		const auto key = [&](std::size_t field) -> const K& {
+			if (fields.size() <= field)
+				throw std::runtime_error("missing key");
+			const auto named_key = state->keys.find(fields[field]);
+			if (named_key == state->keys.end())
+				throw std::runtime_error("unknown key " + fields[field]);
+			return named_key->second;
+		};
+
+		const std::string& command = fields[0];
+		response << "ok";
+		if (command == "keys")
+			for (const auto& named_key : state->keys)
+				response << "\t" << named_key.first;
+		else if (command == "mu")
+			response << "\t" << state->analyzer.mu(key(1));
+		else if (command == "sigma")
+			response << "\t" << state->analyzer.sigma(key(1));
+		else if (command == "samples")
+			for (const T& sample : state->analyzer.samples(key(1)))
+				response << "\t" << sample;
+		else if (command == "cov")
+			response << "\t" << state->analyzer.covariance(key(1), key(2));
+		else
+			throw std::runtime_error("unknown command " + command);
+	} catch (const std::exception& e) {
+		response.str("");
+		response << "error\t" << e.what();
+	}
+	return response.str();
+}
+
+}
+}
+}
@@ -0,0 +1,149 @@
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <RawHistory.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T>
+constexpr std::size_t RawHistory<T>::block_size;
+
+template<typename T>
+RawHistory<T>::RawHistory(const std::vector<T>& samples, raw_encoding encoding) :
+		N { samples.size() }, format { encoding } {
+
+	encode(samples);
+}
+
+template<typename T>
+RawHistory<T>::RawHistory(std::vector<T>&& samples, raw_encoding encoding) :
+		N { samples.size() }, format { encoding } {
+
+	if (format == raw_encoding::exact)
+		exact_values = std::move(samples);
+	else
+		encode(samples);
+}
+
+template<typename T>
+std::size_t RawHistory<T>::size() const {
+	return N;
+}
+
+template<typename T>
+raw_encoding RawHistory<T>::encoding() const {
+	return format;
+}
+
+template<typename T>
+std::size_t RawHistory<T>::memory() const {
+	return exact_values.size() * sizeof(T) + float_values.size() * sizeof(float)
+			+ mantissas_32.size() * sizeof(std::int32_t) + mantissas_16.size() * sizeof(std::int16_t)
+			+ exponents.size() * sizeof(int) + non_finite_values.size() * sizeof(std::pair<std::size_t, T>);
+}
+
+template<typename T>
+std::vector<T> RawHistory<T>::decode() const {
+	std::vector<T> decoded(N);
+	decode(0, N, decoded.data());
+	return decoded;
+}
+
+template<typename T>
+void RawHistory<T>::decode(std::size_t first, std::size_t last, T* decoded) const {
+	if (first > last || last > N)
+		throw std::out_of_range("RawHistory::decode range exceeds number of samples");
+
+	switch (format) {
+	case raw_encoding::exact:
+		std::copy(exact_values.begin() + first, exact_values.begin() + last, decoded);
+		break;
+	case raw_encoding::single_precision:
+		std::copy(float_values.begin() + first, float_values.begin() + last, decoded);
+		break;
+	case raw_encoding::shared_exponent_32:
+		decode_shared_exponent(mantissas_32, first, last, decoded);
+		break;
+	case raw_encoding::shared_exponent_16:
+		decode_shared_exponent(mantissas_16, first, last, decoded);
+		break;
+	}
+}
+
+// ************************************** private **************************************
+
+template<typename T>
+void RawHistory<T>::encode(const std::vector<T>& samples) {
+	switch (format) {
+	case raw_encoding::exact:
+		exact_values = samples;
+		break;
+	case raw_encoding::single_precision:
+		float_values.assign(samples.begin(), samples.end());
+		break;
+	case raw_encoding::shared_exponent_32:
+		encode_shared_exponent(samples, mantissas_32);
+		break;
+	case raw_encoding::shared_exponent_16:
+		encode_shared_exponent(samples, mantissas_16);
+		break;
+	}
+}
+
+template<typename T>
+template<typename M>
+void RawHistory<T>::encode_shared_exponent(const std::vector<T>& samples, std::vector<M>& mantissas) {
+	const int mantissa_bits = std::numeric_limits<M>::digits;
+	mantissas.resize(N);
+
+	for (std::size_t block_first = 0; block_first < N; block_first += block_size) {
+		const std::size_t block_last = std::min(N, block_first + block_size);
+
+		T max_magnitude = 0;
+		for (std::size_t i = block_first; i < block_last; ++i)
+			if (std::isfinite(samples[i]))
+				max_magnitude = std::max(max_magnitude, static_cast<T>(std::abs(samples[i])));
+
+		int exponent = 0; // max_magnitude < 2^exponent
+		if (max_magnitude > 0)
+			std::frexp(max_magnitude, &exponent);
+		exponents.push_back(exponent);
+
+		for (std::size_t i = block_first; i < block_last; ++i) {
+			if (!std::isfinite(samples[i])) { // would be rounded and converted to an integer out of range
+				mantissas[i] = 0;
+				non_finite_values.emplace_back(i, samples[i]);
+				continue;
+			}
+			const long double scaled = std::ldexp(static_cast<long double>(samples[i]), mantissa_bits - exponent);
+			const long double max_mantissa = std::numeric_limits<M>::max();
+			mantissas[i] = static_cast<M>(std::max(-max_mantissa, std::min(max_mantissa, std::round(scaled))));
+		}
+	}
+}
+
+template<typename T>
+template<typename M>
+void RawHistory<T>::decode_shared_exponent(const std::vector<M>& mantissas, std::size_t first, std::size_t last,
+		T* decoded) const {
+	const int mantissa_bits = std::numeric_limits<M>::digits;
+	for (std::size_t i = first; i < last; ++i)
+		decoded[i - first] = static_cast<T>(std::ldexp(static_cast<long double>(mantissas[i]),
+				exponents[i / block_size] - mantissa_bits));
+
+	auto non_finite = std::lower_bound(non_finite_values.begin(), non_finite_values.end(), first,
+			[](const std::pair<std::size_t, T>& value, std::size_t i) {return value.first < i;});
+	for (; non_finite != non_finite_values.end() && non_finite->first < last; ++non_finite)
+		decoded[non_finite->first - first] = non_finite->second;
+}
+
+}
+}
+}
@@ -0,0 +1,62 @@
+#include <vector>
+#include <algorithm>
+
+#include <Reduction.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+namespace reduction {
+
+template<typename A, typename Accumulate, typename Combine>
+A reduce(std::size_t n, const A& zero, Accumulate accumulate, Combine combine, reduction_mode mode, bool concurrent) {
+#ifndef _OPENMP
+	(void) concurrent; // blocks are always accumulated by the calling thread
+#endif
+	const std::size_t num_blocks = (n + block_size - 1) / block_size;
+	if (mode == reduction_mode::sequential || num_blocks <= 1) {
+		A result = zero;
+		accumulate(result, 0, n);
+		return result;
+	}
+
+	if (mode == reduction_mode::fast) {
+		A result = zero;
+#pragma omp parallel if(concurrent)
+		{
+			A partial = zero;
+#pragma omp for schedule(static) nowait
+			for (std::size_t k = 0; k < num_blocks; ++k)
+				accumulate(partial, k * block_size, std::min(n, (k + 1) * block_size));
+#pragma omp critical
+			combine(result, partial);
+		}
+		return result;
+	}
+
+	std::vector<A> partials(num_blocks, zero);
+#pragma omp parallel for schedule(static) if(concurrent)
+	for (std::size_t k = 0; k < num_blocks; ++k)
+		accumulate(partials[k], k * block_size, std::min(n, (k + 1) * block_size));
+
+	// the tree only depends on num_blocks
+	for (std::size_t stride = 1; stride < num_blocks; stride *= 2)
+		for (std::size_t k = 0; k + stride < num_blocks; k += 2 * stride)
+			combine(partials[k], partials[k + stride]);
+	return partials.front();
+}
+
+template<typename T, typename Term>
+T sum(std::size_t n, Term term, reduction_mode mode, bool concurrent) {
+	return reduce<T>(n, 0, [&term](T& partial, std::size_t first, std::size_t last) {
+		for (std::size_t i = first; i < last; ++i)
+			partial += term(i);
+	}, [](T& partial, const T& other) {
+		partial += other;
+	}, mode, concurrent);
+}
+
+}
+}
+}
+}
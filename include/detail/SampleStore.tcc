@@ -0,0 +1,172 @@
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#include <SampleStore.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T, typename Layout>
+constexpr std::size_t SampleStore<T, Layout>::default_page_bytes;
+
+template<typename T, typename Layout>
+SampleStore<T, Layout>::SampleStore(std::size_t slot_size, std::size_t page_bytes) :
+		slot_size { slot_size } {
+
+	const std::size_t tile_bytes = std::max<std::size_t>(1, slot_size * stride() * sizeof(T));
+	slots_per_page = std::max<std::size_t>(1, page_bytes / tile_bytes) * stride();
+}
+
+template<typename T, typename Layout>
+std::size_t SampleStore<T, Layout>::allocate() {
+	std::size_t slot;
+	if (!free_slots.empty()) {
+		slot = free_slots.back();
+		free_slots.pop_back();
+		slot_used[slot] = true;
+	} else {
+		slot = slot_used.size();
+		if (slot == pages.size() * slots_per_page) {
+			pages.emplace_back();
+			page_slots_used.push_back(0);
+		}
+		slot_used.push_back(true);
+	}
+
+	const std::size_t page = slot / slots_per_page;
+	if (page_slots_used[page]++ == 0)
+		pages[page] = new_page();
+	return slot;
+}
+
+template<typename T, typename Layout>
+void SampleStore<T, Layout>::release(std::size_t slot) {
+	if (slot < slot_used.size() && slot_used[slot]) {
+		slot_used[slot] = false;
+		free_slots.push_back(slot);
+
+		const std::size_t page = slot / slots_per_page;
+		if (--page_slots_used[page] == 0)
+			pages[page].reset();
+	}
+}
+
+template<typename T, typename Layout>
+constexpr std::size_t SampleStore<T, Layout>::stride() {
+	return Layout::lanes;
+}
+
+template<typename T, typename Layout>
+const T* SampleStore<T, Layout>::data(std::size_t slot) const {
+	return pages[slot / slots_per_page].get() + offset(slot);
+}
+
+template<typename T, typename Layout>
+T* SampleStore<T, Layout>::mutable_data(std::size_t slot) {
+	auto& page = pages[slot / slots_per_page];
+	if (page.use_count() > 1) {
+		std::shared_ptr<T> copy = new_page();
+		std::copy(page.get(), page.get() + slots_per_page * slot_size, copy.get());
+		page = std::move(copy);
+	} else {
+		// use_count() is a relaxed load, this pairs with the release decrement by which another thread dropped its
+		// copy, so that its reads of the page happen before the writes through the returned pointer
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	return page.get() + offset(slot);
+}
+
+template<typename T, typename Layout>
+void SampleStore<T, Layout>::read(std::size_t slot, T* elements) const {
+	const T* slot_data = data(slot);
+	for (std::size_t i = 0; i < slot_size; ++i)
+		elements[i] = slot_data[i * stride()];
+}
+
+template<typename T, typename Layout>
+void SampleStore<T, Layout>::write(std::size_t slot, const T* elements) {
+	T* slot_data = mutable_data(slot);
+	for (std::size_t i = 0; i < slot_size; ++i)
+		slot_data[i * stride()] = elements[i];
+}
+
+template<typename T, typename Layout>
+const T* SampleStore<T, Layout>::tile_data(std::size_t slot, std::size_t& lane) const {
+	lane = slot % stride();
+	return data(slot) - lane;
+}
+
+template<typename T, typename Layout>
+std::size_t SampleStore<T, Layout>::size() const {
+	return slot_used.size() - free_slots.size();
+}
+
+template<typename T, typename Layout>
+std::size_t SampleStore<T, Layout>::capacity() const {
+	return (pages.size() - std::count(page_slots_used.begin(), page_slots_used.end(), 0)) * slots_per_page;
+}
+
+template<typename T, typename Layout>
+std::size_t SampleStore<T, Layout>::page_size() const {
+	return slots_per_page;
+}
+
+template<typename T, typename Layout>
+std::vector<std::size_t> SampleStore<T, Layout>::compact() {
+	std::vector<std::size_t> new_slots(slot_used.size());
+	for (std::size_t slot = 0; slot < new_slots.size(); ++slot)
+		new_slots[slot] = slot;
+
+	std::sort(free_slots.begin(), free_slots.end());
+	std::size_t end = slot_used.size();
+	for (const std::size_t hole : free_slots) {
+		while (end > 0 && !slot_used[end - 1])
+			--end;
+		if (hole >= end)
+			break;
+
+		--end;
+		const std::size_t hole_page = hole / slots_per_page, end_page = end / slots_per_page;
+		if (page_slots_used[hole_page]++ == 0)
+			pages[hole_page] = new_page();
+		T* hole_data = mutable_data(hole);
+		const T* end_data = data(end);
+		for (std::size_t i = 0; i < slot_size; ++i)
+			hole_data[i * stride()] = end_data[i * stride()];
+		slot_used[hole] = true;
+		slot_used[end] = false;
+		if (--page_slots_used[end_page] == 0)
+			pages[end_page].reset();
+		new_slots[end] = hole;
+	}
+
+	slot_used.resize(size());
+	free_slots.clear();
+	pages.resize((slot_used.size() + slots_per_page - 1) / slots_per_page);
+	pages.shrink_to_fit();
+	page_slots_used.resize(pages.size());
+
+	return new_slots;
+}
+
+// ************************************** private **************************************
+
+template<typename T, typename Layout>
+std::size_t SampleStore<T, Layout>::offset(std::size_t slot) const {
+	// element i of the slot is at tile * stride * slot_size + i * stride + lane
+	const std::size_t slot_in_page = slot % slots_per_page;
+	return (slot_in_page - slot_in_page % stride()) * slot_size + slot_in_page % stride();
+}
+
+template<typename T, typename Layout>
+std::shared_ptr<T> SampleStore<T, Layout>::new_page() const {
+	return std::shared_ptr<T>(new T[slots_per_page * slot_size](), std::default_delete<T[]>());
+}
+
+}
+}
+}
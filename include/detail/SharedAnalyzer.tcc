@@ -0,0 +1,249 @@
+#include <vector>
+#include <string>
+#include <map>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <atomic>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <SharedAnalyzer.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T>
+constexpr std::uint64_t SharedAnalyzer<T>::magic;
+template<typename T>
+constexpr std::uint64_t SharedAnalyzer<T>::no_samples;
+
+template<typename T>
+template<typename K, typename Layout>
+void SharedAnalyzer<T>::publish(const std::string& segment_name, const JackknifeAnalyzer<K, T, Layout>& analyzer,
+		std::function<std::string(const K&)> key_name) {
+	static_assert(std::is_arithmetic<T>::value, "SharedAnalyzer requires an arithmetic type");
+
+	std::map<std::string, K> named_keys;
+	for (const K& key : analyzer.key_view())
+		named_keys.emplace(key_name(key), key);
+
+	std::size_t names_size = 0, num_rows = 0;
+	std::vector<key_entry> table;
+	std::vector<const K*> sampled_keys;
+	for (const auto& named_key : named_keys) {
+		const bool terminal = analyzer.is_terminal(named_key.second);
+		table.push_back( { names_size, named_key.first.size(), terminal ? no_samples : num_rows,
+				analyzer.mu(named_key.second), analyzer.sigma(named_key.second), analyzer.bias(named_key.second) });
+		names_size += named_key.first.size();
+		if (!terminal) {
+			sampled_keys.push_back(&named_key.second);
+			++num_rows;
+		}
+	}
+
+	// the sample matrix starts at a multiple of 64 bytes
+	segment_header head { magic, sizeof(T), analyzer.num_bins(), table.size(), 0, 0 };
+	head.names_offset = sizeof(segment_header) + table.size() * sizeof(key_entry);
+	head.samples_offset = (head.names_offset + names_size + 63) / 64 * 64;
+	const std::size_t size = head.samples_offset + num_rows * head.num_bins * sizeof(T);
+
+	shm_unlink(segment_name.c_str());
+	const int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0)
+		throw std::runtime_error("could not create shared memory segment " + segment_name);
+	void* mapped = MAP_FAILED;
+	if (ftruncate(fd, size) == 0)
+		mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED) {
+		shm_unlink(segment_name.c_str());
+		throw std::runtime_error("could not create shared memory segment " + segment_name);
+	}
+
+	// readers reject the segment until the magic number is written last
+	unsigned char* data = static_cast<unsigned char*>(mapped);
+	head.magic = 0;
+	std::memcpy(data, &head, sizeof(head));
+	std::memcpy(data + sizeof(head), table.data(), table.size() * sizeof(key_entry));
+	std::size_t name_position = head.names_offset;
+	for (const auto& named_key : named_keys) {
+		std::memcpy(data + name_position, named_key.first.data(), named_key.first.size());
+		name_position += named_key.first.size();
+	}
+	for (std::size_t row = 0; row < sampled_keys.size(); ++row) {
+		const std::vector<T> X_samples = analyzer.samples(*sampled_keys[row]);
+		std::memcpy(data + head.samples_offset + row * head.num_bins * sizeof(T), X_samples.data(),
+				head.num_bins * sizeof(T));
+	}
+	std::atomic_thread_fence(std::memory_order_release);
+	reinterpret_cast<volatile std::uint64_t*>(data)[0] = magic;
+	munmap(mapped, size);
+}
+
+template<typename T>
+void SharedAnalyzer<T>::unlink(const std::string& segment_name) {
+	shm_unlink(segment_name.c_str());
+}
+
+template<typename T>
+SharedAnalyzer<T>::SharedAnalyzer(const std::string& segment_name) :
+		segment { nullptr }, segment_size { 0 } {
+
+	const int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+		throw std::runtime_error("could not open shared memory segment " + segment_name);
+	struct stat status;
+	void* mapped = MAP_FAILED;
+	if (fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(segment_header)) {
+		segment_size = status.st_size;
+		mapped = mmap(nullptr, segment_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (mapped == MAP_FAILED)
+		throw std::runtime_error("could not open shared memory segment " + segment_name);
+
+	segment = static_cast<const unsigned char*>(mapped);
+	const std::uint64_t segment_magic = reinterpret_cast<const volatile std::uint64_t*>(segment)[0];
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (segment_magic != magic || !is_consistent()) {
+		munmap(mapped, segment_size);
+		throw std::runtime_error("trying to attach to a shared memory segment of different format " + segment_name);
+	}
+}
+
+template<typename T>
+SharedAnalyzer<T>::~SharedAnalyzer() {
+	munmap(const_cast<unsigned char*>(segment), segment_size);
+}
+
+template<typename T>
+std::size_t SharedAnalyzer<T>::num_bins() const {
+	return header().num_bins;
+}
+
+template<typename T>
+std::vector<std::string> SharedAnalyzer<T>::keys() const {
+	std::vector<std::string> names;
+	for (std::size_t k = 0; k < header().num_keys; ++k)
+		names.push_back(name(entries()[k]));
+	return names;
+}
+
+template<typename T>
+bool SharedAnalyzer<T>::jackknife(const std::string& Xkey, T& mu_X, T& sigma_X) const {
+	const key_entry* entry = find_entry(Xkey);
+	if (entry == nullptr)
+		return false;
+	mu_X = entry->mu;
+	sigma_X = entry->sigma;
+	return true;
+}
+
+template<typename T>
+T SharedAnalyzer<T>::mu(const std::string& Xkey) const {
+	return find(Xkey).mu;
+}
+
+template<typename T>
+T SharedAnalyzer<T>::sigma(const std::string& Xkey) const {
+	return find(Xkey).sigma;
+}
+
+template<typename T>
+T SharedAnalyzer<T>::bias(const std::string& Xkey) const {
+	return find(Xkey).bias;
+}
+
+template<typename T>
+const T* SharedAnalyzer<T>::samples(const std::string& Xkey) const {
+	const key_entry& entry = find(Xkey);
+	if (entry.samples_row == no_samples)
+		throw std::runtime_error("trying to access samples of a terminal variable.");
+	return reinterpret_cast<const T*>(segment + header().samples_offset) + entry.samples_row * header().num_bins;
+}
+
+template<typename T>
+T SharedAnalyzer<T>::covariance(const std::string& Xkey, const std::string& Ykey) const {
+	const T* X_samples = samples(Xkey);
+	const T* Y_samples = samples(Ykey);
+	const T mu_X = mu(Xkey), mu_Y = mu(Ykey);
+	const std::size_t N_bins = num_bins();
+
+	using accumulator = typename std::common_type<T, double>::type;
+	accumulator sum = 0;
+	for (std::size_t i = 0; i < N_bins; ++i)
+		sum += (accumulator) (X_samples[i] - mu_X) * (Y_samples[i] - mu_Y);
+	return (T) ((accumulator) (N_bins - 1) / N_bins * sum);
+}
+
+// ************************************** private **************************************
+
+template<typename T>
+bool SharedAnalyzer<T>::is_consistent() const {
+	// checked without overflow, given segment_size >= sizeof(segment_header)
+	const segment_header& head = header();
+	if (head.value_size != sizeof(T)
+			|| head.num_keys > (segment_size - sizeof(segment_header)) / sizeof(key_entry)
+			|| head.names_offset != sizeof(segment_header) + head.num_keys * sizeof(key_entry)
+			|| head.samples_offset < head.names_offset || head.samples_offset > segment_size
+			|| head.samples_offset % alignof(T) != 0 || head.num_bins > segment_size / sizeof(T))
+		return false;
+
+	const std::uint64_t names_size = head.samples_offset - head.names_offset;
+	const std::uint64_t num_rows = head.num_bins == 0 ? 0 :
+			(segment_size - head.samples_offset) / (head.num_bins * sizeof(T));
+	for (std::size_t k = 0; k < head.num_keys; ++k) {
+		const key_entry& entry = entries()[k];
+		if (entry.name_length > names_size || entry.name_offset > names_size - entry.name_length
+				|| (entry.samples_row != no_samples && entry.samples_row >= num_rows))
+			return false;
+	}
+	return true;
+}
+
+template<typename T>
+const typename SharedAnalyzer<T>::segment_header& SharedAnalyzer<T>::header() const {
+	return *reinterpret_cast<const segment_header*>(segment);
+}
+
+template<typename T>
+const typename SharedAnalyzer<T>::key_entry* SharedAnalyzer<T>::entries() const {
+	return reinterpret_cast<const key_entry*>(segment + sizeof(segment_header));
+}
+
+template<typename T>
+std::string SharedAnalyzer<T>::name(const key_entry& entry) const {
+	return std::string(reinterpret_cast<const char*>(segment + header().names_offset + entry.name_offset),
+			entry.name_length);
+}
+
+template<typename T>
+const typename SharedAnalyzer<T>::key_entry& SharedAnalyzer<T>::find(const std::string& Xkey) const {
+	const key_entry* entry = find_entry(Xkey);
+	if (entry == nullptr)
+		throw std::out_of_range("SharedAnalyzer key does not exist");
+	return *entry;
+}
+
+template<typename T>
+const typename SharedAnalyzer<T>::key_entry* SharedAnalyzer<T>::find_entry(const std::string& Xkey) const {
+	// entries are sorted by name
+	const key_entry* first = entries();
+	const key_entry* last = first + header().num_keys;
+	const char* names = reinterpret_cast<const char*>(segment + header().names_offset);
+	const key_entry* entry = std::lower_bound(first, last, Xkey, [names](const key_entry& e, const std::string& key) {
+		return key.compare(0, key.size(), names + e.name_offset, e.name_length) > 0;
+	});
+	return entry != last && Xkey.compare(0, Xkey.size(), names + entry->name_offset, entry->name_length) == 0 ?
+			entry : nullptr;
+}
+
+}
+}
+}
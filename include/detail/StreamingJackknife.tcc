@@ -0,0 +1,125 @@
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include <StreamingJackknife.hh>
+
+namespace de_uni_frankfurt_itp {
+namespace reisinger {
+namespace jackknife_analyzer_0219 {
+
+template<typename T>
+StreamingJackknife<T>::StreamingJackknife(std::size_t window_bins, std::size_t bin_size) :
+		window_bins { window_bins }, bin_size { bin_size }, current_bin_sum { 0 }, current_bin_samples { 0 },
+		shift { 0 }, shifted_sum { 0 }, shifted_squares { 0 }, removed_since_recompute { 0 } {
+
+	if (window_bins < 2)
+		throw std::runtime_error("trying to create window with less than 2 bins.");
+	if (bin_size == 0)
+		throw std::runtime_error("trying to create window with empty bins.");
+}
+
+template<typename T>
+void StreamingJackknife<T>::add(const T& sample) {
+	current_bin_sum += sample;
+	if (++current_bin_samples < bin_size)
+		return;
+
+	if (bin_sums.empty())
+		shift = current_bin_sum;
+	bin_sums.push_back(current_bin_sum);
+	const running_sum entering = current_bin_sum - shift;
+	shifted_sum += entering;
+	shifted_squares += entering * entering;
+	current_bin_sum = 0;
+	current_bin_samples = 0;
+
+	if (bin_sums.size() > window_bins) {
+		const running_sum leaving = bin_sums.front() - shift;
+		shifted_sum -= leaving;
+		shifted_squares -= leaving * leaving;
+		bin_sums.pop_front();
+		if (++removed_since_recompute == window_bins)
+			recompute();
+	}
+}
+
+template<typename T>
+std::size_t StreamingJackknife<T>::num_bins() const {
+	return bin_sums.size();
+}
+
+template<typename T>
+bool StreamingJackknife<T>::jackknife(T& mu, T& sigma) const {
+	if (bin_sums.size() < 2)
+		return false;
+
+	// as for JackknifeAnalyzer::jackknife_range(...), the squared deviations of the jackknife samples
+	// (S - B_b) / (n - bin_size) from the mean S / n sum to (sum_b B_b^2 - S^2 / M) / (n - bin_size)^2
+	const std::size_t M = bin_sums.size(), num_samples = M * bin_size;
+	mu = static_cast<T>((shifted_sum + static_cast<running_sum>(M) * shift) / static_cast<running_sum>(num_samples));
+
+	const running_sum squared_deviations = std::max((running_sum) 0,
+			shifted_squares - shifted_sum * shifted_sum / static_cast<running_sum>(M))
+			/ pow(static_cast<running_sum>(num_samples - bin_size), (running_sum) 2);
+	sigma = static_cast<T>(sqrt((((running_sum) (M - 1)) / ((running_sum) M)) * squared_deviations));
+	return true;
+}
+
+template<typename T>
+T StreamingJackknife<T>::mu() const {
+	verify_num_bins();
+	T mu, sigma;
+	jackknife(mu, sigma);
+	return mu;
+}
+
+template<typename T>
+T StreamingJackknife<T>::sigma() const {
+	verify_num_bins();
+	T mu, sigma;
+	jackknife(mu, sigma);
+	return sigma;
+}
+
+template<typename T>
+std::vector<T> StreamingJackknife<T>::samples() const {
+	verify_num_bins();
+	const std::size_t num_samples = bin_sums.size() * bin_size;
+	const running_sum sum_samples = shifted_sum + static_cast<running_sum>(bin_sums.size()) * shift;
+
+	std::vector<T> jackknife_samples;
+	for (const T& bin_sum : bin_sums)
+		jackknife_samples.push_back(
+				static_cast<T>((sum_samples - bin_sum) / static_cast<running_sum>(num_samples - bin_size)));
+	return jackknife_samples;
+}
+
+// ************************************** private **************************************
+
+template<typename T>
+void StreamingJackknife<T>::recompute() {
+	running_sum sum = 0;
+	for (const T& bin_sum : bin_sums)
+		sum += bin_sum;
+	shift = sum / static_cast<running_sum>(bin_sums.size());
+
+	shifted_sum = shifted_squares = 0;
+	for (const T& bin_sum : bin_sums) {
+		shifted_sum += bin_sum - shift;
+		shifted_squares += (bin_sum - shift) * (bin_sum - shift);
+	}
+	removed_since_recompute = 0;
+}
+
+template<typename T>
+void StreamingJackknife<T>::verify_num_bins() const {
+	if (bin_sums.size() < 2)
+		throw std::runtime_error("trying to compute jackknife of window with less than 2 bins.");
+}
+
+}
+}
+}
@@ -0,0 +1,86 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::size_t N_samples = 40, N_times = 7;
+
+// raw samples of a periodic correlator, one vector per time slice
+std::vector<std::vector<double> > raw_correlator(double phase) {
+	std::vector<std::vector<double> > C(N_times);
+	for (std::size_t t = 0; t < N_times; ++t)
+		for (std::size_t i = 0; i < N_samples; ++i)
+			C[t].push_back(std::cosh(0.4 * (t - 3.5)) * (1 + 0.05 * std::sin(0.37 * i + phase + t)));
+	return C;
+}
+
+std::vector<std::string> keys(const std::string& name, std::size_t num_keys) {
+	std::vector<std::string> names;
+	for (std::size_t t = 0; t < num_keys; ++t)
+		names.push_back(name + std::to_string(t));
+	return names;
+}
+
+void resample(JackknifeAnalyzer<std::string, double>& analyzer, const std::string& name,
+		const std::vector<std::vector<double> >& C) {
+	for (std::size_t t = 0; t < C.size(); ++t)
+		analyzer.resample(name + std::to_string(t), C[t]);
+}
+
+void compare(const JackknifeAnalyzer<std::string, double>& analyzer, const std::vector<std::string>& keys,
+		const JackknifeAnalyzer<std::string, double>& expected, const std::string& name) {
+	for (std::size_t t = 0; t < keys.size(); ++t) {
+		const std::string expected_key = name + std::to_string(t);
+		assert(std::abs(analyzer.mu(keys[t]) - expected.mu(expected_key)) < 1e-12);
+		for (std::size_t b = 0; b < analyzer.num_bins(); ++b)
+			assert(std::abs(analyzer.samples(keys[t])[b] - expected.samples(expected_key)[b]) < 1e-12);
+	}
+}
+
+}
+
+/**
+ * Folding and averaging resampled correlators agrees with folding and averaging the raw samples before resampling,
+ * both are replayed by rebin(...), and nothing is done if all output keys exist, even if inputs were removed.
+ */
+int main() {
+	const std::vector<std::vector<double> > C0 = raw_correlator(0), C1 = raw_correlator(1);
+	JackknifeAnalyzer<std::string, double> analyzer(2), expected(2);
+	resample(analyzer, "C0_", C0);
+	resample(analyzer, "C1_", C1);
+	resample(expected, "fold", correlator::fold(C0, -1.0));
+	resample(expected, "avg", correlator::average<double>( { C0, C1 }, { 0, 2 }));
+
+	const std::vector<std::string> folded = keys("F", N_times / 2 + 1), averaged = keys("A", N_times);
+	analyzer.add_folded_correlator(folded, keys("C0_", N_times), -1);
+	analyzer.add_averaged_correlator(averaged, { keys("C0_", N_times), keys("C1_", N_times) }, { 0, 2 });
+	compare(analyzer, folded, expected, "fold");
+	compare(analyzer, averaged, expected, "avg");
+
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(2), expected_rebinned = expected.rebin(2);
+	compare(rebinned, folded, expected_rebinned, "fold");
+	compare(rebinned, averaged, expected_rebinned, "avg");
+
+	bool thrown = false;
+	try {
+		analyzer.add_folded_correlator(keys("G", N_times), keys("C0_", N_times));
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	for (const std::string& key : keys("C1_", N_times))
+		analyzer.remove(key);
+	const double F0 = analyzer.mu("F0");
+	analyzer.add_folded_correlator(folded, keys("C1_", N_times), -1);
+	analyzer.add_averaged_correlator(averaged, { keys("C0_", N_times), keys("C1_", N_times) }, { 0, 2 });
+	assert(analyzer.mu("F0") == F0);
+	return 0;
+}
@@ -0,0 +1,136 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::size_t N_samples = 60, N_points = 8;
+
+double intercept(std::size_t i) {
+	return 2 + 0.1 * std::sin(0.7 * i);
+}
+
+double slope(std::size_t i) {
+	return 0.5 + 0.05 * std::cos(1.3 * i);
+}
+
+template<typename T>
+std::vector<std::string> add_data(JackknifeAnalyzer<std::string, T>& analyzer) {
+	std::vector<T> a, b;
+	for (std::size_t i = 0; i < N_samples; ++i) {
+		a.push_back(intercept(i));
+		b.push_back(slope(i));
+	}
+	analyzer.resample("a", a);
+	analyzer.resample("b", b);
+	std::vector<std::string> y_keys;
+	for (std::size_t t = 0; t < N_points; ++t) {
+		std::vector<T> y;
+		for (std::size_t i = 0; i < N_samples; ++i)
+			y.push_back(intercept(i) + slope(i) * t + 0.01 * std::sin(0.9 * i * (t + 1) + 0.3 * t * t));
+		y_keys.push_back("y" + std::to_string(t));
+		analyzer.resample(y_keys.back(), y);
+	}
+	return y_keys;
+}
+
+void check_estimate() {
+	JackknifeAnalyzer<std::string, double> analyzer;
+	const std::vector<std::string> y_keys = add_data(analyzer);
+	const CovarianceEstimate<double> estimate = analyzer.covariance_estimate(y_keys);
+	assert(estimate.size() == N_points);
+	for (std::size_t i = 0; i < N_points; ++i)
+		for (std::size_t j = 0; j < N_points; ++j) {
+			const double expected = analyzer.covariance(y_keys[i], y_keys[j]);
+			assert(std::abs(estimate.matrix()[i * N_points + j] - expected) < 1e-12 * std::abs(expected) + 1e-15);
+		}
+
+	// L L^T reproduces the matrix, and chi2 agrees with an explicit solve
+	const std::vector<double>& L = estimate.cholesky_factor();
+	for (std::size_t i = 0; i < N_points; ++i)
+		for (std::size_t j = 0; j < N_points; ++j) {
+			double product = 0;
+			for (std::size_t k = 0; k < N_points; ++k)
+				product += L[i * N_points + k] * L[j * N_points + k];
+			assert(std::abs(product - estimate.matrix()[i * N_points + j]) < 1e-10 * estimate.matrix()[i * N_points + i]);
+		}
+	std::vector<double> residuals(N_points), solution(N_points);
+	for (std::size_t i = 0; i < N_points; ++i)
+		residuals[i] = analyzer.sigma(y_keys[i]) * std::cos(0.3 * i);
+	estimate.solve(residuals.data(), solution.data());
+	double chi2 = 0;
+	for (std::size_t i = 0; i < N_points; ++i)
+		chi2 += residuals[i] * solution[i];
+	assert(std::abs(estimate.chi2(residuals.data()) - chi2) < 1e-8 * chi2);
+
+	const CovarianceEstimate<double> shrunk = analyzer.covariance_estimate(y_keys, 0.25);
+	for (std::size_t i = 0; i < N_points; ++i)
+		for (std::size_t j = 0; j < N_points; ++j) {
+			const double scale = i == j ? 1 : 0.75;
+			assert(std::abs(shrunk.matrix()[i * N_points + j] - scale * estimate.matrix()[i * N_points + j])
+					< 1e-15 + 1e-12 * std::abs(estimate.matrix()[i * N_points + j]));
+		}
+
+	bool thrown = false;
+	try {
+		analyzer.covariance_estimate(y_keys, 2);
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+// the bin sum of 10^5 squares near 1 drifts by far more than float precision if it is accumulated in float
+void check_float_accumulation() {
+	const std::size_t N_bins = 100000;
+	std::vector<float> samples(N_bins), means { 0 };
+	double exact = 0;
+	for (std::size_t b = 0; b < N_bins; ++b) {
+		samples[b] = 1.0002f + 1e-4f * std::sin(0.1f * b);
+		exact += (double) samples[b] * samples[b];
+	}
+	exact *= (N_bins - 1.) / N_bins;
+	const CovarianceEstimate<float> estimate(samples, means);
+	assert(std::abs(estimate.matrix()[0] - exact) < 1e-6 * exact);
+}
+
+}
+
+/**
+ * The covariance estimate agrees with the pairwise jackknife covariance, its Cholesky factor and solver are
+ * consistent and shrinkage scales the off-diagonal elements. If each jackknife sample lies exactly on a line, a
+ * correlated fit-window scan reproduces it just like the uncorrelated one.
+ */
+int main() {
+	check_estimate();
+	check_float_accumulation();
+
+	JackknifeAnalyzer<std::string, double> exact;
+	std::vector<double> a, b;
+	for (std::size_t i = 0; i < N_samples; ++i) {
+		a.push_back(intercept(i));
+		b.push_back(slope(i));
+	}
+	exact.resample("a", a);
+	exact.resample("b", b);
+	std::vector<std::string> y_keys;
+	for (std::size_t t = 0; t < N_points; ++t) {
+		y_keys.push_back("y" + std::to_string(t));
+		exact.add_function(y_keys.back(), [t](double a, double b) {return a + b * t;}, "a", "b");
+	}
+	const std::vector<std::function<double(std::size_t)> > basis { [](std::size_t) {return 1.0;},
+			[](std::size_t t) {return (double) t;} };
+	exact.add_fit_window_scan( { "q0", "q1" }, y_keys, basis, exact.covariance_estimate(y_keys, 0.1), 3);
+	for (std::size_t i = 0; i < exact.num_bins(); ++i) {
+		assert(std::abs(exact.samples("q0")[i] - exact.samples("a")[i]) < 1e-10);
+		assert(std::abs(exact.samples("q1")[i] - exact.samples("b")[i]) < 1e-10);
+	}
+	return 0;
+}
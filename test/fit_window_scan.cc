@@ -0,0 +1,95 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::size_t N_samples = 60, N_points = 8;
+
+double intercept(std::size_t i) {
+	return 2 + 0.1 * std::sin(0.7 * i);
+}
+
+double slope(std::size_t i) {
+	return 0.5 + 0.05 * std::cos(1.3 * i);
+}
+
+double noise(std::size_t i, std::size_t t) {
+	return 0.01 * std::sin(0.9 * i + 2.1 * t);
+}
+
+template<typename T>
+void add_data(JackknifeAnalyzer<std::string, T>& analyzer, bool noisy) {
+	std::vector<T> a, b;
+	for (std::size_t i = 0; i < N_samples; ++i) {
+		a.push_back(intercept(i));
+		b.push_back(slope(i));
+	}
+	analyzer.resample("a", a);
+	analyzer.resample("b", b);
+	for (std::size_t t = 0; t < N_points; ++t) {
+		std::vector<T> y;
+		for (std::size_t i = 0; i < N_samples; ++i)
+			y.push_back(intercept(i) + slope(i) * t + (noisy ? noise(i, t) : 0));
+		analyzer.resample("y" + std::to_string(t), y);
+	}
+}
+
+template<typename T>
+std::vector<std::function<T(std::size_t)> > linear_basis() {
+	return { [](std::size_t) {return T(1);}, [](std::size_t t) {return T(t);} };
+}
+
+}
+
+/**
+ * If each jackknife sample lies exactly on a line, every window and therefore the model average reproduces it, also
+ * for float data. With a single window, the scan is an ordinary weighted fit. Existing parameter keys are kept.
+ */
+int main() {
+	std::vector<std::string> y_keys;
+	for (std::size_t t = 0; t < N_points; ++t)
+		y_keys.push_back("y" + std::to_string(t));
+
+	JackknifeAnalyzer<std::string, double> exact;
+	add_data(exact, false);
+	exact.add_fit_window_scan( { "p0", "p1" }, y_keys, linear_basis<double>(), 3);
+	for (std::size_t i = 0; i < exact.num_bins(); ++i) {
+		assert(std::abs(exact.samples("p0")[i] - exact.samples("a")[i]) < 1e-10);
+		assert(std::abs(exact.samples("p1")[i] - exact.samples("b")[i]) < 1e-10);
+	}
+
+	JackknifeAnalyzer<std::string, float> single_precision;
+	add_data(single_precision, false);
+	single_precision.add_fit_window_scan( { "p0", "p1" }, y_keys, linear_basis<float>(), 3);
+	assert(std::abs(single_precision.mu("p0") - single_precision.mu("a")) < 1e-4);
+	assert(std::abs(single_precision.sigma("p1") - single_precision.sigma("b")) < 1e-3 * single_precision.sigma("b"));
+
+	// weighted least squares on the means: p = (F^T W F)^-1 F^T W y with W = diag(1 / sigma^2)
+	JackknifeAnalyzer<std::string, double> noisy;
+	add_data(noisy, true);
+	noisy.add_fit_window_scan( { "p0", "p1" }, y_keys, linear_basis<double>(), N_points);
+	double s = 0, st = 0, stt = 0, sy = 0, sty = 0;
+	for (std::size_t t = 0; t < N_points; ++t) {
+		const double w = 1 / std::pow(noisy.sigma(y_keys[t]), 2), y = noisy.mu(y_keys[t]);
+		s += w;
+		st += w * t;
+		stt += w * t * t;
+		sy += w * y;
+		sty += w * t * y;
+	}
+	const double det = s * stt - st * st;
+	assert(std::abs(noisy.mu("p0") - (stt * sy - st * sty) / det) < 1e-10);
+	assert(std::abs(noisy.mu("p1") - (s * sty - st * sy) / det) < 1e-10);
+
+	const double p0 = noisy.mu("p0");
+	noisy.add_fit_window_scan( { "p0", "p1" }, y_keys, linear_basis<double>(), 3);
+	assert(noisy.mu("p0") == p0);
+	return 0;
+}
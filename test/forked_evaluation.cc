@@ -0,0 +1,107 @@
+#include "JackknifeAnalyzer.hh"
+#include "ForkedEvaluation.hh"
+
+#include <cassert>
+#include <cmath>
+#include <csignal>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+std::size_t num_calls = 0;
+
+double counted_square(std::size_t i) {
+	++num_calls;
+	return (double) i * i;
+}
+
+void ignore(int) {
+}
+
+bool evaluation_throws(std::size_t num_processes) {
+	std::vector<double> results(10);
+	try {
+		evaluate_forked(results.size(), num_processes, [](std::size_t i) {
+			if (i == 7)
+				throw std::runtime_error("failed");
+			return 1.0 * i;
+		}, results.data());
+	} catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+}
+
+/**
+ * Children evaluate all indices, their side effects are lost, and failing children make the evaluation throw. Signals
+ * handled by the calling process while it waits for its children do not fail the evaluation. Adding a function in
+ * child processes agrees with adding it in the calling process. Once OpenMP has started its thread pool, the
+ * evaluation falls back to the calling process.
+ */
+int main() {
+	assert(!process_is_multithreaded());
+	std::vector<double> results(101);
+	evaluate_forked(results.size(), 4, counted_square, results.data());
+	for (std::size_t i = 0; i < results.size(); ++i)
+		assert(results[i] == (double) i * i);
+	assert(num_calls == 0);
+	evaluate_forked(results.size(), 1, counted_square, results.data());
+	assert(num_calls == results.size());
+
+	assert(evaluation_throws(3));
+	assert(evaluation_throws(1));
+
+	// a timer firing every millisecond interrupts waiting for the slow children, without restarting
+	struct sigaction action { };
+	action.sa_handler = ignore;
+	sigaction(SIGALRM, &action, nullptr);
+	const itimerval every_millisecond { { 0, 1000 }, { 0, 1000 } };
+	setitimer(ITIMER_REAL, &every_millisecond, nullptr);
+	evaluate_forked(results.size(), 4, [](std::size_t i) {
+		usleep(1000);
+		return 2.0 * i;
+	}, results.data());
+	const itimerval disarmed { };
+	setitimer(ITIMER_REAL, &disarmed, nullptr);
+	for (std::size_t i = 0; i < results.size(); ++i)
+		assert(results[i] == 2.0 * i);
+
+	JackknifeAnalyzer<std::string, double> analyzer;
+	std::vector<double> x, y;
+	for (std::size_t i = 0; i < 40; ++i) {
+		x.push_back(1 + 0.1 * std::sin(0.37 * i));
+		y.push_back(2 + 0.1 * std::cos(0.53 * i));
+	}
+	analyzer.resample("x", x);
+	analyzer.resample("y", y);
+	const auto F = [](const std::vector<double>& args) {return args[0] / args[1];};
+	analyzer.add_function_forked("forked", F, { "x", "y" }, 3);
+	analyzer.add_function("serial", F, std::vector<std::string> { "x", "y" });
+	assert(analyzer.samples("forked") == analyzer.samples("serial"));
+	assert(analyzer.mu("forked") == analyzer.mu("serial"));
+
+#ifdef _OPENMP
+	// the thread pool of the parallel region stays alive, so the children could deadlock on its locks
+#pragma omp parallel num_threads(2)
+	{
+	}
+	assert(process_is_multithreaded());
+	num_calls = 0;
+	evaluate_forked(results.size(), 4, counted_square, results.data());
+	assert(num_calls == results.size());
+	for (std::size_t i = 0; i < results.size(); ++i)
+		assert(results[i] == (double) i * i);
+	analyzer.add_function_forked("forked after OpenMP", F, { "x", "y" }, 3);
+	assert(analyzer.samples("forked after OpenMP") == analyzer.samples("serial"));
+#endif
+	return 0;
+}
@@ -0,0 +1,119 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const double pi = std::acos(-1.0);
+
+// direct DFT of a single array over 2 dimensions (row-major points)
+void dft(const std::vector<double>& re, const std::vector<double>& im, std::size_t L0, std::size_t L1, int sign,
+		std::vector<double>& re_out, std::vector<double>& im_out) {
+	re_out.assign(L0 * L1, 0);
+	im_out.assign(L0 * L1, 0);
+	for (std::size_t k0 = 0; k0 < L0; ++k0)
+		for (std::size_t k1 = 0; k1 < L1; ++k1)
+			for (std::size_t x0 = 0; x0 < L0; ++x0)
+				for (std::size_t x1 = 0; x1 < L1; ++x1) {
+					const double phase = sign * 2 * pi * ((double) k0 * x0 / L0 + (double) k1 * x1 / L1);
+					const std::size_t x = x0 * L1 + x1, k = k0 * L1 + k1;
+					re_out[k] += re[x] * std::cos(phase) - im[x] * std::sin(phase);
+					im_out[k] += re[x] * std::sin(phase) + im[x] * std::cos(phase);
+				}
+}
+
+// a batch of 3 arrays, batch index innermost, on a radix-2 and a direct axis
+void check_batched_fft(int sign) {
+	const std::size_t L0 = 4, L1 = 3, batch = 3;
+	std::vector<double> re(L0 * L1 * batch), im(L0 * L1 * batch);
+	for (std::size_t i = 0; i < re.size(); ++i) {
+		re[i] = std::sin(0.7 * i);
+		im[i] = std::cos(1.1 * i);
+	}
+	std::vector<double> re_transformed = re, im_transformed = im;
+	BatchedFFT<double>( { L0, L1 }, sign).transform(re_transformed.data(), im_transformed.data(), batch);
+
+	for (std::size_t n = 0; n < batch; ++n) {
+		std::vector<double> re_array, im_array, re_expected, im_expected;
+		for (std::size_t x = 0; x < L0 * L1; ++x) {
+			re_array.push_back(re[x * batch + n]);
+			im_array.push_back(im[x * batch + n]);
+		}
+		dft(re_array, im_array, L0, L1, sign, re_expected, im_expected);
+		for (std::size_t k = 0; k < L0 * L1; ++k) {
+			assert(std::abs(re_transformed[k * batch + n] - re_expected[k]) < 1e-12);
+			assert(std::abs(im_transformed[k * batch + n] - im_expected[k]) < 1e-12);
+		}
+	}
+}
+
+}
+
+/**
+ * Batched transforms agree with a direct DFT on radix-2 and other axes. Transforming resampled variables agrees with
+ * transforming the means and every jackknife sample, rebin(...) replays the transform, and nothing is done if all
+ * output keys exist, even if inputs were removed.
+ */
+int main() {
+	check_batched_fft(-1);
+	check_batched_fft(1);
+
+	const std::size_t L0 = 4, L1 = 3, N_points = L0 * L1;
+	JackknifeAnalyzer<std::string, double> analyzer;
+	std::vector<std::string> in_keys, re_keys, im_keys;
+	for (std::size_t x = 0; x < N_points; ++x) {
+		std::vector<double> samples;
+		for (std::size_t i = 0; i < 20; ++i)
+			samples.push_back(std::exp(-0.3 * x) * (1 + 0.1 * std::sin(0.37 * i + x)));
+		in_keys.push_back("C" + std::to_string(x));
+		re_keys.push_back("re" + std::to_string(x));
+		im_keys.push_back("im" + std::to_string(x));
+		analyzer.resample(in_keys.back(), samples);
+	}
+	analyzer.add_fourier_transform(re_keys, im_keys, in_keys, { }, { L0, L1 });
+
+	std::vector<double> means, zeros(N_points, 0), re_expected, im_expected;
+	for (const std::string& key : in_keys)
+		means.push_back(analyzer.mu(key));
+	dft(means, zeros, L0, L1, -1, re_expected, im_expected);
+	for (std::size_t k = 0; k < N_points; ++k) {
+		assert(std::abs(analyzer.mu(re_keys[k]) - re_expected[k]) < 1e-12);
+		assert(std::abs(analyzer.mu(im_keys[k]) - im_expected[k]) < 1e-12);
+	}
+	for (std::size_t b = 0; b < analyzer.num_bins(); ++b) {
+		std::vector<double> bin;
+		for (const std::string& key : in_keys)
+			bin.push_back(analyzer.samples(key)[b]);
+		dft(bin, zeros, L0, L1, -1, re_expected, im_expected);
+		for (std::size_t k = 0; k < N_points; ++k) {
+			assert(std::abs(analyzer.samples(re_keys[k])[b] - re_expected[k]) < 1e-12);
+			assert(std::abs(analyzer.samples(im_keys[k])[b] - im_expected[k]) < 1e-12);
+		}
+	}
+
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(2);
+	double sum = 0;
+	for (const std::string& key : in_keys)
+		sum += rebinned.mu(key);
+	assert(std::abs(rebinned.mu("re0") - sum) < 1e-12);
+
+	bool thrown = false;
+	try {
+		analyzer.add_fourier_transform(re_keys, im_keys, in_keys, { }, { L0 });
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	analyzer.remove("C0");
+	const double re1 = analyzer.mu("re1");
+	analyzer.add_fourier_transform(re_keys, im_keys, in_keys, { }, { L0, L1 });
+	assert(analyzer.mu("re1") == re1);
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+// scratch space of a function, counting how many were made
+struct workspace {
+	static int num_made;
+	std::vector<double> scratch;
+	workspace() :
+			scratch(2) {
+		++num_made;
+	}
+};
+
+int workspace::num_made = 0;
+
+double ratio(const std::vector<double>& args, workspace& w) {
+	w.scratch[0] = args[0];
+	w.scratch[1] = args[1];
+	return w.scratch[0] / w.scratch[1];
+}
+
+}
+
+/**
+ * Adding a function with a workspace agrees with adding it without and makes one workspace in serial builds, and at
+ * most one per thread with OpenMP. Exceptions of the function and of the workspace factory are rethrown.
+ */
+int main() {
+	JackknifeAnalyzer<std::string, double> analyzer;
+	std::vector<double> x, y;
+	for (std::size_t i = 0; i < 200; ++i) {
+		x.push_back(1 + 0.1 * std::sin(0.37 * i));
+		y.push_back(2 + 0.1 * std::cos(0.53 * i));
+	}
+	analyzer.resample("x", x);
+	analyzer.resample("y", y);
+
+	analyzer.add_function_with_workspace("f", ratio, []() {return workspace();}, { "x", "y" });
+#ifdef _OPENMP
+	assert(workspace::num_made >= 1 && workspace::num_made <= omp_get_max_threads());
+#else
+	assert(workspace::num_made == 1);
+#endif
+	analyzer.add_function("g", [](double x, double y) {return x / y;}, "x", "y");
+	assert(analyzer.mu("f") == analyzer.mu("g"));
+	assert(analyzer.samples("f") == analyzer.samples("g"));
+
+	// fails for some jackknife samples, but not for the mean
+	const double mu_x = analyzer.mu("x");
+	bool thrown = false;
+	try {
+		analyzer.add_function_with_workspace("h", [mu_x](const std::vector<double>& args, workspace&) {
+			if (args[0] < mu_x)
+				throw std::runtime_error("failed");
+			return args[0];
+		}, []() {return workspace();}, { "x" });
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	thrown = false;
+	try {
+		analyzer.add_function_with_workspace("h", ratio, []() -> workspace {throw std::runtime_error("failed");},
+				{ "x", "y" });
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+	return 0;
+}
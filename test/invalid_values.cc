@@ -0,0 +1,56 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+std::vector<double> data(std::size_t num_samples) {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < num_samples; ++i)
+		x.push_back(1 + 0.1 * std::sin(0.37 * i));
+	return x;
+}
+
+}
+
+/**
+ * NaN and infinite values are reported with the input bins containing them for resampled variables, with the bins in
+ * which they occur for derived variables, and without bins for terminal variables. Valid and removed variables are
+ * not reported.
+ */
+int main() {
+	JackknifeAnalyzer<std::string, double> analyzer(2);
+	analyzer.resample("x", data(40));
+	std::vector<double> y = data(40);
+	y[5] = std::numeric_limits<double>::quiet_NaN();
+	y[30] = std::numeric_limits<double>::infinity();
+	analyzer.resample("y", y);
+	assert(analyzer.is_valid("x"));
+	assert(!analyzer.is_valid("y"));
+	assert(analyzer.invalid_bins("y") == std::vector<std::size_t>( { 2, 15 }));
+
+	// the logarithm of x - x_7 is -infinity in bin 7 only
+	const double x7 = analyzer.samples("x")[7];
+	analyzer.add_function("log", [x7](double x) {return std::log(std::abs(x - x7));}, "x");
+	assert(!analyzer.is_valid("log"));
+	assert(analyzer.invalid_bins("log") == std::vector<std::size_t>( { 7 }));
+
+	analyzer.add_terminal_function("terminal", [](double y) {return 2 * y;}, "y");
+	assert(!analyzer.is_valid("terminal"));
+	assert(analyzer.invalid_bins("terminal").empty());
+
+	assert(analyzer.invalid_keys() == std::vector<std::string>( { "log", "terminal", "y" }));
+	assert(analyzer.is_valid("unknown"));
+	assert(analyzer.invalid_bins("x").empty());
+
+	analyzer.remove("y");
+	analyzer.remove("terminal");
+	assert(analyzer.invalid_keys() == std::vector<std::string>( { "log" }));
+	return 0;
+}
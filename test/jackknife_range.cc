@@ -0,0 +1,86 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+// a drift makes the prefix sums large compared to the sums over a range
+template<typename T>
+std::vector<T> data(std::size_t num_samples, double drift) {
+	std::vector<T> x;
+	for (std::size_t i = 0; i < num_samples; ++i)
+		x.push_back(drift * i / num_samples + std::sin(0.37 * i));
+	return x;
+}
+
+// mean and jackknife error of the samples [first, last) with the given bin size, in double precision
+void jackknife(const std::vector<float>& x, std::size_t first, std::size_t last, std::size_t bin_size, double& mu,
+		double& sigma) {
+	const std::size_t num_bins = (last - first) / bin_size;
+	double sum = 0;
+	for (std::size_t i = first; i < last; ++i)
+		sum += x[i];
+	mu = sum / (last - first);
+	double squares = 0;
+	for (std::size_t b = 0; b < num_bins; ++b) {
+		double bin_sum = 0;
+		for (std::size_t i = first + b * bin_size; i < first + (b + 1) * bin_size; ++i)
+			bin_sum += x[i];
+		const double sample = (sum - bin_sum) / (last - first - bin_size);
+		squares += (sample - mu) * (sample - mu);
+	}
+	sigma = std::sqrt((num_bins - 1.) / num_bins * squares);
+}
+
+}
+
+/**
+ * The mean and error of a range of bins agree with resampling the samples of that range, and only retained raw
+ * histories have prefix sums. Float data with many bins keeps float precision.
+ */
+int main() {
+	const std::vector<double> x = data<double>(300, 0);
+	JackknifeAnalyzer<std::string, double> analyzer(3);
+	analyzer.resample("u", x);
+	analyzer.retain_raw_histories(true);
+	analyzer.resample("x", x);
+
+	double mu, sigma;
+	assert(!analyzer.jackknife_range("u", 10, 50, mu, sigma));
+	assert(analyzer.jackknife_range("x", 10, 50, mu, sigma));
+	JackknifeAnalyzer<std::string, double> cut(3);
+	cut.resample("x", std::vector<double>(x.begin() + 30, x.begin() + 150));
+	assert(std::abs(mu - cut.mu("x")) < 1e-12);
+	assert(std::abs(sigma - cut.sigma("x")) < 1e-12);
+
+	assert(analyzer.jackknife_range("x", 0, analyzer.num_bins(), mu, sigma));
+	assert(std::abs(mu - analyzer.mu("x")) < 1e-12);
+	assert(std::abs(sigma - analyzer.sigma("x")) < 1e-12);
+
+	bool thrown = false;
+	try {
+		analyzer.jackknife_range("x", 10, 11, mu, sigma);
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	const std::size_t N_float = 400000;
+	const std::vector<float> y = data<float>(N_float, 100);
+	JackknifeAnalyzer<std::string, float> single_precision(2);
+	single_precision.retain_raw_histories(true);
+	single_precision.resample("y", y);
+	float mu_y, sigma_y;
+	assert(single_precision.jackknife_range("y", N_float / 4, N_float / 2, mu_y, sigma_y));
+	double exact_mu, exact_sigma;
+	jackknife(y, N_float / 2, N_float, 2, exact_mu, exact_sigma);
+	assert(std::abs(mu_y - exact_mu) < 1e-6 * exact_mu);
+	assert(std::abs(sigma_y - exact_sigma) < 1e-4 * exact_sigma);
+	return 0;
+}
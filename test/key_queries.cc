@@ -0,0 +1,92 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+// key component counting its comparisons
+struct counted {
+	static std::size_t num_comparisons;
+	int value;
+
+	bool operator<(const counted& other) const {
+		++num_comparisons;
+		return value < other.value;
+	}
+};
+
+std::size_t counted::num_comparisons = 0;
+
+template<typename Range>
+std::vector<typename Range::iterator::value_type> collect(const Range& range) {
+	return { range.begin(), range.end() };
+}
+
+}
+
+/**
+ * Key views, prefix queries on string and tuple keys and wildcard queries select exactly the matching keys in
+ * ascending order. Prefix queries do not scan all keys, and wildcard queries do not backtrack exponentially.
+ */
+int main() {
+	const std::vector<double> x { 1, 2, 3, 4 };
+
+	JackknifeAnalyzer<std::string, double> analyzer;
+	for (const std::string key : { "pion/t1", "pion/t0", "pio", "pion", "rho/t0", "pion/t10", "kaon/t0" })
+		analyzer.resample(key, x);
+
+	assert(analyzer.key_view().size() == 7);
+	assert(collect(analyzer.key_view()) == analyzer.keys());
+	assert((collect(analyzer.key_view("pion", "rho")) == std::vector<std::string> { "pion", "pion/t0", "pion/t1",
+			"pion/t10" }));
+	assert(analyzer.key_view("rho", "pion").empty());
+
+	assert((collect(analyzer.keys_with_prefix("pion/")) == std::vector<std::string> { "pion/t0", "pion/t1", "pion/t10" }));
+	assert(analyzer.keys_with_prefix(std::string("pio")).size() == 5);
+	assert(analyzer.keys_with_prefix("sigma").empty());
+	assert(analyzer.keys_with_prefix("").size() == 7);
+
+	assert((analyzer.keys_matching("pion/t?") == std::vector<std::string> { "pion/t0", "pion/t1" }));
+	assert((analyzer.keys_matching("*/t0") == std::vector<std::string> { "kaon/t0", "pion/t0", "rho/t0" }));
+	assert((analyzer.keys_matching("p*n") == std::vector<std::string> { "pion" }));
+	assert(analyzer.keys_matching("pion/t1*").size() == 2);
+
+	assert(analyzer.keys_matching("**/t*0").size() == 4);
+
+	analyzer.remove("pion/t1");
+	assert(analyzer.keys_with_prefix("pion/").size() == 2);
+
+	using tuple_key = std::tuple<std::string, int, int>;
+	JackknifeAnalyzer<tuple_key, double> tuples;
+	for (int t = 0; t < 3; ++t)
+		for (int p = 0; p < 2; ++p) {
+			tuples.resample(tuple_key("pion", p, t), x);
+			tuples.resample(tuple_key("kaon", p, t), x);
+		}
+	assert(tuples.keys_with_prefix(std::make_tuple(std::string("pion"))).size() == 6);
+	for (const tuple_key& key : tuples.keys_with_prefix(std::make_tuple(std::string("kaon"), 1)))
+		assert(std::get<0>(key) == "kaon" && std::get<1>(key) == 1);
+	assert(tuples.keys_with_prefix(std::make_tuple(std::string("kaon"), 1)).size() == 3);
+	assert(tuples.keys_with_prefix(std::make_tuple(std::string("rho"))).empty());
+
+	JackknifeAnalyzer<std::string, double> long_keys;
+	long_keys.resample(std::string(60, 'a'), x);
+	long_keys.resample(std::string(60, 'a') + "b", x);
+	assert(long_keys.keys_matching("a*a*a*a*a*a*a*a*a*a*a*a*b").size() == 1);
+	assert(long_keys.keys_matching("*a*a*a*a*a*a*a*a*a*a*a*a*c").empty());
+
+	// a prefix query compares about as many keys as a lookup, not all of them
+	using counted_key = std::tuple<counted, int>;
+	JackknifeAnalyzer<counted_key, double> many;
+	for (int k = 0; k < 4096; ++k)
+		many.resample(counted_key(counted { k / 4 }, k % 4), x);
+	counted::num_comparisons = 0;
+	assert(many.keys_with_prefix(std::make_tuple(counted { 517 })).size() == 4);
+	assert(counted::num_comparisons < 200);
+	return 0;
+}
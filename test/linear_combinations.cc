@@ -0,0 +1,77 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::size_t N_in = 5, N_out = 3;
+
+std::vector<double> data(std::size_t num_samples, double phase) {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < num_samples; ++i)
+		x.push_back(1 + 0.1 * std::sin(0.37 * i + phase));
+	return x;
+}
+
+}
+
+/**
+ * Each linear combination agrees with the same combination computed by add_function(...), rebin(...) replays them,
+ * and nothing is done if all output keys exist, even if inputs were removed.
+ */
+int main() {
+	JackknifeAnalyzer<std::string, double> analyzer(2);
+	std::vector<std::string> in_keys, out_keys;
+	std::vector<double> coefficients;
+	for (std::size_t k = 0; k < N_in; ++k) {
+		in_keys.push_back("x" + std::to_string(k));
+		analyzer.resample(in_keys.back(), data(60, k));
+	}
+	for (std::size_t o = 0; o < N_out; ++o) {
+		out_keys.push_back("y" + std::to_string(o));
+		for (std::size_t k = 0; k < N_in; ++k)
+			coefficients.push_back(std::cos(1.7 * o + 0.9 * k));
+	}
+
+	// y1 already exists and is left unchanged
+	analyzer.add_function("y1", [](double x) {return x;}, "x0");
+	analyzer.add_linear_combinations(out_keys, coefficients, in_keys);
+	for (std::size_t o = 0; o < N_out; ++o) {
+		const double* c = &coefficients[o * N_in];
+		analyzer.add_function("z" + std::to_string(o), [c](double x0, double x1, double x2, double x3, double x4) {
+			return c[0] * x0 + c[1] * x1 + c[2] * x2 + c[3] * x3 + c[4] * x4;
+		}, "x0", "x1", "x2", "x3", "x4");
+	}
+	for (const std::size_t o : { 0, 2 }) {
+		const std::string y = "y" + std::to_string(o), z = "z" + std::to_string(o);
+		assert(std::abs(analyzer.mu(y) - analyzer.mu(z)) < 1e-12);
+		for (std::size_t b = 0; b < analyzer.num_bins(); ++b)
+			assert(std::abs(analyzer.samples(y)[b] - analyzer.samples(z)[b]) < 1e-12);
+	}
+	assert(analyzer.mu("y1") == analyzer.mu("x0"));
+
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(3);
+	assert(std::abs(rebinned.mu("y2") - rebinned.mu("z2")) < 1e-12);
+	assert(std::abs(rebinned.sigma("y2") - rebinned.sigma("z2")) < 1e-12);
+	assert(rebinned.mu("y1") == rebinned.mu("x0"));
+
+	bool thrown = false;
+	try {
+		analyzer.add_linear_combinations( { "w" }, coefficients, in_keys);
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	analyzer.remove("x4");
+	const double y0 = analyzer.mu("y0");
+	analyzer.add_linear_combinations(out_keys, coefficients, in_keys);
+	assert(analyzer.mu("y0") == y0);
+	return 0;
+}
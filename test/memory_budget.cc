@@ -0,0 +1,125 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::string scratch_path = "memory_budget.scratch";
+
+bool scratch_exists() {
+	return std::ifstream(scratch_path).good();
+}
+
+std::streamoff scratch_size() {
+	return std::ifstream(scratch_path, std::ios::binary | std::ios::ate).tellg();
+}
+
+void compare_with_unbudgeted() {
+	const std::size_t N_bins = 64;
+	JackknifeAnalyzer<std::string, double> budgeted, unbudgeted;
+	budgeted.set_memory_budget(4 * N_bins * sizeof(double), scratch_path);
+	for (std::size_t k = 0; k < 16; ++k) {
+		std::vector<double> x;
+		for (std::size_t i = 0; i < N_bins; ++i)
+			x.push_back(std::sin(0.1 * (i + 1) * (k + 1)));
+		budgeted.resample("x" + std::to_string(k), x);
+		unbudgeted.resample("x" + std::to_string(k), x);
+	}
+	assert(scratch_exists());
+
+	// both arguments were spilled and are paged in
+	budgeted.add_function("f", [](double x0, double x1) {return x0 * x1;}, "x0", "x1");
+	unbudgeted.add_function("f", [](double x0, double x1) {return x0 * x1;}, "x0", "x1");
+
+	for (const std::string& key : unbudgeted.keys()) {
+		assert(budgeted.mu(key) == unbudgeted.mu(key));
+		assert(budgeted.sigma(key) == unbudgeted.sigma(key));
+		assert(budgeted.samples(key) == unbudgeted.samples(key));
+		assert(budgeted.covariance(key, "x3") == unbudgeted.covariance(key, "x3"));
+	}
+
+	// the rebinned analyzer spills to the same scratch file
+	const std::streamoff spilled_size = scratch_size();
+	const JackknifeAnalyzer<std::string, double> budgeted_rebinned = budgeted.rebin(2);
+	assert(scratch_size() > spilled_size);
+	const JackknifeAnalyzer<std::string, double> unbudgeted_rebinned = unbudgeted.rebin(2);
+	for (const std::string& key : budgeted_rebinned.keys())
+		assert(budgeted_rebinned.samples(key) == unbudgeted_rebinned.samples(key));
+
+	budgeted.remove("x0");
+	assert(budgeted.keys().size() == 16);
+
+	bool thrown = false;
+	try {
+		budgeted.set_memory_budget(4 * N_bins * sizeof(double), scratch_path + ".other");
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+JackknifeAnalyzer<std::string, double> with_variables(std::size_t num_variables, std::size_t num_resident) {
+	const std::size_t N_bins = 64;
+	JackknifeAnalyzer<std::string, double> analyzer;
+	analyzer.set_memory_budget(num_resident * N_bins * sizeof(double), scratch_path);
+	for (std::size_t k = 0; k < num_variables; ++k) {
+		std::vector<double> x;
+		for (std::size_t i = 0; i < N_bins; ++i)
+			x.push_back(std::cos(0.2 * (i + 1) * (k + 1)));
+		analyzer.resample("x" + std::to_string(k), x);
+	}
+	return analyzer;
+}
+
+void reuse_removed_extents() {
+	JackknifeAnalyzer<std::string, double> analyzer = with_variables(16, 4);
+	const std::streamoff spilled_size = scratch_size();
+	for (std::size_t k = 0; k < 8; ++k)
+		analyzer.remove("x" + std::to_string(k));
+	for (std::size_t k = 0; k < 8; ++k)
+		analyzer.resample("y" + std::to_string(k), analyzer.samples("x" + std::to_string(k + 8)));
+	assert(scratch_size() == spilled_size);
+
+	// extents still referred to by a copy are not reused
+	const JackknifeAnalyzer<std::string, double> copy = analyzer;
+	const std::vector<double> y0 = copy.samples("y0");
+	analyzer.remove("y0");
+	analyzer.resample("z", y0);
+	analyzer.add_function("w", [](double z) {return 2 * z;}, "z");
+	assert(copy.samples("y0") == y0);
+}
+
+void enforce_after_terminal_function() {
+	JackknifeAnalyzer<std::string, double> analyzer = with_variables(8, 2);
+	const std::streamoff spilled_size = scratch_size();
+
+	// pages in all spilled arguments, so the previously resident variables have to be spilled
+	std::vector<std::string> args;
+	for (std::size_t k = 0; k < 6; ++k)
+		args.push_back("x" + std::to_string(k));
+	analyzer.add_terminal_function("t", [](std::vector<double> x) {return x[0] + x[5];}, args);
+	assert(scratch_size() > spilled_size);
+}
+
+}
+
+/**
+ * With a memory budget, cold variables are spilled to the scratch file and paged in again when they are used,
+ * without changing any result, also after rebinning. Space of removed variables in the scratch file is reused, and
+ * terminal functions stay within the budget. The scratch file is deleted with the last analyzer using it.
+ */
+int main() {
+	compare_with_unbudgeted();
+	assert(!scratch_exists());
+	reuse_removed_extents();
+	enforce_after_terminal_function();
+	assert(!scratch_exists());
+	return 0;
+}
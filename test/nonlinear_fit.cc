@@ -0,0 +1,96 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+// the last batch of W = 4 bins is incomplete
+const std::size_t N_samples = 41, N_points = 6;
+
+double amplitude(std::size_t i) {
+	return 2 + 0.1 * std::sin(0.7 * i);
+}
+
+double mass(std::size_t i) {
+	return 0.3 + 0.02 * std::cos(1.3 * i);
+}
+
+double exponential(std::size_t t, const double* p, double* gradient) {
+	const double e = std::exp(-p[1] * t);
+	gradient[0] = e;
+	gradient[1] = -(double) t * p[0] * e;
+	return p[0] * e;
+}
+
+double constant(std::size_t, const double* p, double* gradient) {
+	gradient[0] = 1;
+	gradient[1] = 0;
+	return p[0];
+}
+
+double failing(std::size_t, const double*, double*) {
+	throw std::runtime_error("model failed");
+}
+
+bool throws(JackknifeAnalyzer<std::string, double>& analyzer, const std::vector<std::string>& parameter_keys,
+		const std::vector<std::string>& y_keys, double (*model)(std::size_t, const double*, double*),
+		const std::vector<double>& initial_parameters) {
+	try {
+		analyzer.add_nonlinear_fit<4>(parameter_keys, y_keys, model, initial_parameters);
+	} catch (const std::exception&) {
+		return true;
+	}
+	return false;
+}
+
+}
+
+/**
+ * If each jackknife sample lies exactly on an exponential, the fits reproduce its parameters in every bin. If a
+ * parameter does not affect the model, all parameters are NaN. Exceptions thrown by the model are rethrown and existing
+ * parameter keys are left unchanged.
+ */
+int main() {
+	JackknifeAnalyzer<std::string, double> analyzer;
+	std::vector<double> A, m;
+	for (std::size_t i = 0; i < N_samples; ++i) {
+		A.push_back(amplitude(i));
+		m.push_back(mass(i));
+	}
+	analyzer.resample("A", A);
+	analyzer.resample("m", m);
+	std::vector<std::string> y_keys;
+	for (std::size_t t = 0; t < N_points; ++t) {
+		y_keys.push_back("y" + std::to_string(t));
+		analyzer.add_function(y_keys.back(), [t](double A, double m) {return A * std::exp(-m * t);}, "A", "m");
+	}
+
+	analyzer.add_nonlinear_fit<4>( { "p0", "p1" }, y_keys, exponential, { 1.0, 0.1 });
+	assert(std::abs(analyzer.mu("p0") - analyzer.mu("A")) < 1e-8);
+	assert(std::abs(analyzer.mu("p1") - analyzer.mu("m")) < 1e-8);
+	for (std::size_t i = 0; i < analyzer.num_bins(); ++i) {
+		assert(std::abs(analyzer.samples("p0")[i] - analyzer.samples("A")[i]) < 1e-8);
+		assert(std::abs(analyzer.samples("p1")[i] - analyzer.samples("m")[i]) < 1e-8);
+	}
+
+	analyzer.add_nonlinear_fit<4>( { "c0", "c1" }, y_keys, constant, { 1.0, 0.1 });
+	assert(std::isnan(analyzer.mu("c0")));
+	assert(std::isnan(analyzer.mu("c1")));
+
+	assert(throws(analyzer, { "f0", "f1" }, y_keys, failing, { 1.0, 0.1 }));
+	assert(throws(analyzer, { "f0", "f1" }, y_keys, exponential, { 1.0 }));
+	assert(throws(analyzer, { "f0", "f1" }, { "y0", "z" }, exponential, { 1.0, 0.1 }));
+	assert(analyzer.keys().size() == 2 + N_points + 4);
+
+	// all parameter keys exist, so the model is not called
+	const double p0 = analyzer.mu("p0");
+	assert(!throws(analyzer, { "p0", "p1" }, y_keys, failing, { 1.0, 0.1 }));
+	assert(analyzer.mu("p0") == p0);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "QueryServer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::string socket_path = "query_server.socket", scratch_path = "query_server.scratch";
+const std::size_t N_bins = 32, N_keys = 12;
+
+int connect_client() {
+	sockaddr_un address { };
+	address.sun_family = AF_UNIX;
+	std::strcpy(address.sun_path, socket_path.c_str());
+	const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	assert(fd >= 0);
+	const int connected = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+	assert(connected == 0);
+	(void) connected;
+	return fd;
+}
+
+// sends request and returns the response without its line end, or an empty string if the connection was closed
+std::string query(int fd, const std::string& request) {
+	const std::string line = request + "\n";
+	send(fd, line.data(), line.size(), MSG_NOSIGNAL);
+	std::string response;
+	char c;
+	while (read(fd, &c, 1) == 1 && c != '\n')
+		response += c;
+	return response;
+}
+
+std::vector<std::string> fields(const std::string& response) {
+	std::vector<std::string> split { "" };
+	for (char c : response)
+		if (c == '\t')
+			split.emplace_back();
+		else
+			split.back() += c;
+	return split;
+}
+
+double value(const std::string& response) {
+	const std::vector<std::string> split = fields(response);
+	assert(split.size() == 2 && split[0] == "ok");
+	return std::strtod(split[1].c_str(), nullptr);
+}
+
+}
+
+/**
+ * Queries are answered exactly from the published snapshot of an analyzer with a memory budget, also for spilled
+ * variables and while the analyzer keeps changing. A client holding an idle connection does not block others, and
+ * a client sending an overlong request is disconnected.
+ */
+int main() {
+	JackknifeAnalyzer<std::string, double> analyzer;
+	analyzer.set_memory_budget(4 * N_bins * sizeof(double), scratch_path);
+	for (std::size_t k = 0; k < N_keys; ++k) {
+		std::vector<double> x;
+		for (std::size_t i = 0; i < N_bins; ++i)
+			x.push_back(1 + 0.1 * std::sin(0.37 * i + k));
+		analyzer.resample("x" + std::to_string(k), x);
+	}
+
+	{
+		QueryServer<std::string, double> server(socket_path, [](const std::string& key) {return key;});
+		const int idle = connect_client(), client = connect_client();
+		assert(query(client, "keys") == "error\tnothing published");
+
+		server.publish(analyzer);
+		analyzer.add_function("f", [](double x0, double x1) {return x0 * x1;}, "x0", "x1");
+
+		assert(fields(query(client, "keys")).size() == N_keys + 1);
+		assert(value(query(client, "mu\tx0")) == analyzer.mu("x0"));
+		assert(value(query(client, "sigma\tx0")) == analyzer.sigma("x0"));
+		assert(value(query(client, "cov\tx0\tx5")) == analyzer.covariance("x0", "x5"));
+		const std::vector<std::string> samples = fields(query(client, "samples\tx1"));
+		assert(samples.size() == N_bins + 1 && samples[0] == "ok");
+		for (std::size_t b = 0; b < N_bins; ++b)
+			assert(std::strtod(samples[b + 1].c_str(), nullptr) == analyzer.samples("x1")[b]);
+		assert(query(client, "mu\tf") == "error\tunknown key f");
+		assert(query(client, "median\tx0") == "error\tunknown command median");
+
+		server.publish(analyzer);
+		assert(value(query(client, "mu\tf")) == analyzer.mu("f"));
+		assert(value(query(idle, "mu\tx2")) == analyzer.mu("x2"));
+
+		const int flooding = connect_client();
+		assert(query(flooding, std::string(QueryServer<std::string, double>::max_request_bytes + 4096, 'x')).empty());
+		assert(value(query(client, "mu\tx3")) == analyzer.mu("x3"));
+
+		close(idle);
+		close(client);
+		close(flooding);
+	}
+	assert(access(socket_path.c_str(), F_OK) != 0);
+	return 0;
+}
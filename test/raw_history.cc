@@ -0,0 +1,129 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+std::vector<double> data(std::size_t num_samples, double phase) {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < num_samples; ++i)
+		x.push_back(std::exp(std::sin(0.37 * i + phase)) * (i % 3 ? 1 : -1));
+	return x;
+}
+
+void check_encoding(raw_encoding encoding, double relative_precision) {
+	const std::vector<double> samples = data(200, 0);
+	const RawHistory<double> history(samples, encoding);
+	assert(history.size() == samples.size());
+	assert(history.encoding() == encoding);
+
+	const std::vector<double> decoded = history.decode();
+	for (std::size_t block = 0; block < samples.size(); block += RawHistory<double>::block_size) {
+		const std::size_t end = std::min(block + RawHistory<double>::block_size, samples.size());
+		double largest = 0;
+		for (std::size_t i = block; i < end; ++i)
+			largest = std::max(largest, std::abs(samples[i]));
+		for (std::size_t i = block; i < end; ++i)
+			assert(std::abs(decoded[i] - samples[i]) <= relative_precision * largest);
+	}
+
+	std::vector<double> range(70);
+	history.decode(60, 130, range.data());
+	assert(std::equal(range.begin(), range.end(), decoded.begin() + 60));
+
+	bool thrown = false;
+	try {
+		history.decode(150, 201, range.data());
+	} catch (const std::exception&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+// NaN and infinite values are decoded exactly, without affecting the precision of the other values in their block
+void check_non_finite(raw_encoding encoding, double relative_precision) {
+	std::vector<double> samples = data(200, 0);
+	samples[3] = std::nan("");
+	samples[70] = std::numeric_limits<double>::infinity();
+	samples[150] = -std::numeric_limits<double>::infinity();
+	const RawHistory<double> history(samples, encoding);
+
+	std::vector<double> decoded(130);
+	history.decode(60, 190, decoded.data());
+	assert(std::isnan(history.decode()[3]));
+	assert(decoded[70 - 60] == samples[70] && decoded[150 - 60] == samples[150]);
+	for (std::size_t i = 60; i < 190; ++i)
+		if (i != 70 && i != 150)
+			assert(std::abs(decoded[i - 60] - samples[i]) <= relative_precision * std::exp(1.));
+}
+
+bool reanalyze_throws(const JackknifeAnalyzer<std::string, double>& analyzer, std::size_t new_bin_size,
+		std::size_t first, std::size_t last) {
+	try {
+		analyzer.reanalyze(new_bin_size, first, last);
+	} catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+}
+
+/**
+ * Raw histories are decoded within the precision of their encoding, NaN and infinite values exactly. Reanalyzing
+ * retained raw histories with a new bin size and cut agrees with resampling the cut samples, also for derived
+ * variables, and retains the cut histories.
+ */
+int main() {
+	check_encoding(raw_encoding::exact, 0);
+	check_encoding(raw_encoding::single_precision, 1e-7);
+	check_encoding(raw_encoding::shared_exponent_32, std::pow(2., -30));
+	check_encoding(raw_encoding::shared_exponent_16, std::pow(2., -14));
+	check_non_finite(raw_encoding::shared_exponent_32, std::pow(2., -30));
+	check_non_finite(raw_encoding::shared_exponent_16, std::pow(2., -14));
+	assert(RawHistory<double>(data(256, 0), raw_encoding::shared_exponent_16).memory()
+			< RawHistory<double>(data(256, 0), raw_encoding::single_precision).memory());
+
+	const std::vector<double> x = data(100, 0), y = data(100, 1);
+	JackknifeAnalyzer<std::string, double> analyzer;
+	analyzer.resample("u", x);
+	analyzer.retain_raw_histories(true);
+	analyzer.resample("x", x);
+	analyzer.resample("y", y);
+	analyzer.add_function("f", [](double x, double y) {return x * y;}, "x", "y");
+	assert(analyzer.raw_history("x") == x);
+
+	bool thrown = false;
+	try {
+		analyzer.raw_history("u");
+	} catch (const std::exception&) {
+		thrown = true;
+	}
+	assert(thrown);
+	assert(reanalyze_throws(analyzer, 4, 10, 90));
+	analyzer.remove("u");
+
+	const JackknifeAnalyzer<std::string, double> reanalyzed = analyzer.reanalyze(4, 10, 90);
+	JackknifeAnalyzer<std::string, double> resampled(4);
+	resampled.resample("x", std::vector<double>(x.begin() + 10, x.begin() + 90));
+	resampled.resample("y", std::vector<double>(y.begin() + 10, y.begin() + 90));
+	resampled.add_function("f", [](double x, double y) {return x * y;}, "x", "y");
+	assert(reanalyzed.num_bins() == 20);
+	for (const std::string key : { "x", "y", "f" }) {
+		assert(std::abs(reanalyzed.mu(key) - resampled.mu(key)) < 1e-12);
+		assert(std::abs(reanalyzed.sigma(key) - resampled.sigma(key)) < 1e-12);
+	}
+	assert(reanalyzed.raw_history("x") == std::vector<double>(x.begin() + 10, x.begin() + 90));
+
+	assert(reanalyze_throws(analyzer, 4, 50, 50));
+	assert(reanalyze_throws(analyzer, 40, 0, 60));
+	return 0;
+}
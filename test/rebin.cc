@@ -0,0 +1,98 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+std::vector<double> data(std::size_t num_samples, double phase) {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < num_samples; ++i)
+		x.push_back(1 + 0.1 * std::sin(0.37 * i + phase));
+	return x;
+}
+
+bool rebin_throws(const JackknifeAnalyzer<std::string, double>& analyzer, std::size_t factor) {
+	try {
+		analyzer.rebin(factor);
+	} catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+void compare_with_resampled() {
+	// 2 samples are left over with bin size 6
+	JackknifeAnalyzer<std::string, double> analyzer(2), resampled(6);
+	for (JackknifeAnalyzer<std::string, double>* a : { &analyzer, &resampled }) {
+		a->resample("x", data(50, 0));
+		a->resample("y", data(50, 1));
+		a->add_function("f", [](double x, double y) {return x / y;}, "x", "y");
+		a->add_function("g", [](double f) {return f * f;}, "f");
+	}
+
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(3);
+	assert(rebinned.num_bins() == resampled.num_bins());
+	for (const std::string key : { "x", "y", "f", "g" }) {
+		assert(std::abs(rebinned.mu(key) - resampled.mu(key)) < 1e-12);
+		assert(std::abs(rebinned.sigma(key) - resampled.sigma(key)) < 1e-12);
+	}
+	assert(rebin_throws(analyzer, 25));
+}
+
+// derivations of removed variables are released without recursion, and replayed if others still use them
+void replay_chain() {
+	const std::size_t length = 100000;
+	JackknifeAnalyzer<std::string, double> analyzer;
+	analyzer.resample("x0", data(8, 0));
+	for (std::size_t k = 1; k <= length; ++k)
+		analyzer.add_function("x" + std::to_string(k), [](double x) {return x + 1;}, "x" + std::to_string(k - 1));
+	for (std::size_t k = 1; k < length; ++k)
+		analyzer.remove("x" + std::to_string(k));
+
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(2);
+	assert(rebinned.keys().size() == 2);
+	assert(std::abs(rebinned.mu("x" + std::to_string(length)) - rebinned.mu("x0") - length) < 1e-6);
+
+	analyzer.remove("x" + std::to_string(length));
+	assert(analyzer.rebin(2).keys().size() == 1);
+}
+
+}
+
+/**
+ * Rebinning by a factor agrees with resampling with the product of the bin sizes, also for derived variables.
+ * Derivations removed variables depend on are replayed, and copies keep their own derivations. Variables which cannot
+ * be reconstructed make rebinning throw.
+ */
+int main() {
+	compare_with_resampled();
+	replay_chain();
+
+	JackknifeAnalyzer<std::string, double> analyzer;
+	analyzer.resample("x", data(40, 0));
+	analyzer.add_function("f", [](double x) {return 2 * x;}, "x");
+	analyzer.add_function("g", [](double f) {return f + 1;}, "f");
+	const JackknifeAnalyzer<std::string, double> copy = analyzer;
+
+	// g keeps using the first derivation of f
+	analyzer.remove("f");
+	analyzer.add_function("f", [](double x) {return 3 * x;}, "x");
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(2), rebinned_copy = copy.rebin(2);
+	assert(std::abs(rebinned.mu("f") - 3 * rebinned.mu("x")) < 1e-12);
+	assert(std::abs(rebinned.mu("g") - 2 * rebinned.mu("x") - 1) < 1e-12);
+	assert(std::abs(rebinned_copy.mu("f") - 2 * rebinned_copy.mu("x")) < 1e-12);
+
+	analyzer.add_resampled("r", analyzer.samples("x"), analyzer.mu("x"));
+	assert(rebin_throws(analyzer, 2));
+	analyzer.remove("r");
+
+	analyzer.remove("x");
+	assert(rebin_throws(analyzer, 2));
+	return 0;
+}
@@ -0,0 +1,39 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+/**
+ * Rebinning replays the latest derivation of a variable which was removed and added again, and keeps the
+ * derivations of removed variables only as long as surviving variables depend on them.
+ */
+int main() {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < 64; ++i)
+		x.push_back(1 + 0.01 * ((i * 37) % 17));
+
+	JackknifeAnalyzer<std::string, double> analyzer(1);
+	analyzer.resample("x", x);
+
+	analyzer.add_function("f", [](double x) {return x;}, "x");
+	analyzer.remove("f");
+	analyzer.add_function("f", [](double x) {return 2 * x;}, "x");
+
+	analyzer.add_function("g", [](double x) {return x * x;}, "x");
+	analyzer.add_function("h", [](double g) {return g + 1;}, "g");
+	analyzer.remove("g");
+
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(2);
+	assert(std::abs(rebinned.mu("f") - 2 * rebinned.mu("x")) < 1e-12);
+	assert(std::abs(rebinned.mu("h") - analyzer.mu("h")) < 1e-12);
+	assert(rebinned.keys().size() == 3);
+
+	analyzer.remove("h");
+	analyzer.remove("f");
+	assert(analyzer.rebin(4).keys().size() == 1);
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::size_t N_samples = 10 * reduction::block_size + 17;
+
+JackknifeAnalyzer<std::string, double> in_mode(reduction_mode mode) {
+	JackknifeAnalyzer<std::string, double> analyzer;
+	analyzer.set_reduction_mode(mode);
+	return analyzer;
+}
+
+std::vector<double> data(std::size_t num_samples) {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < num_samples; ++i)
+		x.push_back(1 + 0.1 * std::sin(0.37 * i) + 1e-3 * std::cos(11.3 * i * i));
+	return x;
+}
+
+// mean and jackknife samples as computed by resample(...) before reduction modes existed
+std::vector<double> plain_resample(const std::vector<double>& x, std::size_t bin_size, double& mu) {
+	double sum_samples = 0;
+	for (double d : x)
+		sum_samples += d;
+	mu = sum_samples / static_cast<double>(x.size());
+
+	std::vector<double> red_samples;
+	for (std::size_t b = 0; b < x.size() / bin_size; ++b) {
+		double red_sample = sum_samples;
+		for (std::size_t i = b * bin_size; i < (b + 1) * bin_size; ++i)
+			red_sample -= x[i];
+		red_samples.push_back(red_sample / static_cast<double>(x.size() - bin_size));
+	}
+	return red_samples;
+}
+
+void check_plain_resample(std::size_t bin_size, bool retain_raw) {
+	const std::vector<double> x = data(N_samples);
+	double mu;
+	const std::vector<double> red_samples = plain_resample(x, bin_size, mu);
+
+	JackknifeAnalyzer<std::string, double> analyzer(bin_size);
+	analyzer.retain_raw_histories(retain_raw);
+	analyzer.resample("x", x);
+	analyzer.resample("moved", data(N_samples));
+	for (const std::string key : { "x", "moved" }) {
+		assert(analyzer.mu(key) == mu);
+		assert(analyzer.samples(key) == red_samples);
+	}
+}
+
+JackknifeAnalyzer<std::string, double> resampled(JackknifeAnalyzer<std::string, double> analyzer) {
+	std::vector<double> y;
+	for (std::size_t i = 0; i < N_samples; ++i)
+		y.push_back(2 + 0.1 * std::cos(0.53 * i));
+	analyzer.resample("x", data(N_samples));
+	analyzer.resample("y", y);
+	return analyzer;
+}
+
+double plain_sigma(const std::vector<double>& samples, double mu) {
+	double sum_squared_deviations = 0;
+	for (const double& sample : samples)
+		sum_squared_deviations += (sample - mu) * (sample - mu);
+	return std::sqrt((samples.size() - 1.) / samples.size() * sum_squared_deviations);
+}
+
+}
+
+/**
+ * Sums over more than one block of bins agree bitwise with plain loops in the default sequential mode, also for the
+ * jackknife samples of resample(...) with larger bins, do not depend on the number of threads in the reproducible
+ * mode, also after rebinning, and agree within rounding in all modes.
+ */
+int main() {
+	const JackknifeAnalyzer<std::string, double> sequential = resampled(JackknifeAnalyzer<std::string, double>());
+	const std::vector<double> x = sequential.samples("x"), y = sequential.samples("y");
+	const double mu_x = sequential.mu("x"), mu_y = sequential.mu("y");
+	double sum_deviations = 0, sum_products = 0;
+	for (std::size_t i = 0; i < N_samples; ++i) {
+		sum_deviations += x[i] - mu_x;
+		sum_products += (x[i] - mu_x) * (y[i] - mu_y);
+	}
+	const double prefactor = (N_samples - 1.) / N_samples;
+	assert(sequential.bias("x") == prefactor * sum_deviations);
+	assert(sequential.sigma("x") == plain_sigma(x, mu_x));
+	assert(sequential.covariance("x", "y") == prefactor * sum_products);
+
+	for (const std::size_t bin_size : { 1, 3 }) {
+		check_plain_resample(bin_size, false);
+		check_plain_resample(bin_size, true);
+	}
+
+	const JackknifeAnalyzer<std::string, double> reproducible = resampled(in_mode(reduction_mode::reproducible));
+#ifdef _OPENMP
+	const int num_threads = omp_get_max_threads();
+	omp_set_num_threads(1);
+	const JackknifeAnalyzer<std::string, double> reproducible_serial = resampled(in_mode(reduction_mode::reproducible));
+	const JackknifeAnalyzer<std::string, double> reproducible_serial_rebinned = reproducible_serial.rebin(2);
+	omp_set_num_threads(num_threads);
+	assert(reproducible.mu("x") == reproducible_serial.mu("x"));
+	assert(reproducible.bias("x") == reproducible_serial.bias("x"));
+	assert(reproducible.sigma("x") == reproducible_serial.sigma("x"));
+	assert(reproducible.covariance("x", "y") == reproducible_serial.covariance("x", "y"));
+	assert(reproducible.rebin(2).sigma("x") == reproducible_serial_rebinned.sigma("x"));
+#endif
+
+	const JackknifeAnalyzer<std::string, double> fast = resampled(in_mode(reduction_mode::fast));
+	for (const JackknifeAnalyzer<std::string, double>* analyzer : { &reproducible, &fast }) {
+		assert(std::abs(analyzer->mu("x") - mu_x) < 1e-14);
+		assert(std::abs(analyzer->bias("x") - sequential.bias("x")) < 1e-8 * sequential.sigma("x"));
+		assert(std::abs(analyzer->sigma("x") - sequential.sigma("x")) < 1e-12 * sequential.sigma("x"));
+		assert(std::abs(analyzer->covariance("x", "y") - sequential.covariance("x", "y"))
+				< 1e-12 * sequential.sigma("x") * sequential.sigma("y"));
+	}
+
+	const JackknifeAnalyzer<std::string, double> sequential_rebinned = sequential.rebin(2);
+	assert(sequential_rebinned.num_bins() > reduction::block_size);
+	assert(sequential_rebinned.sigma("x") == plain_sigma(sequential_rebinned.samples("x"), sequential_rebinned.mu("x")));
+	return 0;
+}
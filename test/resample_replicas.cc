@@ -0,0 +1,80 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+std::vector<std::vector<double> > replicas(double phase) {
+	std::vector<std::vector<double> > x(2);
+	for (std::size_t i = 0; i < 31; ++i)
+		x[0].push_back(1 + 0.1 * std::sin(0.37 * i + phase));
+	for (std::size_t i = 0; i < 20; ++i)
+		x[1].push_back(1.05 + 0.1 * std::cos(0.53 * i + phase));
+	return x;
+}
+
+}
+
+/**
+ * Replicas are binned separately, with samples left over at the end of each replica contributing only to the mean.
+ * Rebinning merges bins within each replica like resampling with the larger bin size, and reanalyzing cuts each
+ * replica.
+ */
+int main() {
+	const std::vector<std::vector<double> > x = replicas(0);
+	JackknifeAnalyzer<std::string, double> analyzer(3);
+	analyzer.retain_raw_histories(true);
+	analyzer.resample_replicas("x", x);
+	analyzer.resample_replicas("y", replicas(1));
+	analyzer.add_function("f", [](double x, double y) {return x / y;}, "x", "y");
+
+	// 10 bins of the first replica, 6 of the second, leaving 1 and 2 samples
+	assert(analyzer.num_bins() == 16);
+	double sum = 0;
+	std::vector<double> bin_sums;
+	for (const std::vector<double>& replica : x) {
+		for (std::size_t b = 0; b < replica.size() / 3; ++b)
+			bin_sums.push_back(replica[3 * b] + replica[3 * b + 1] + replica[3 * b + 2]);
+		for (const double& sample : replica)
+			sum += sample;
+	}
+	assert(std::abs(analyzer.mu("x") - sum / 51) < 1e-12);
+	for (std::size_t b = 0; b < bin_sums.size(); ++b)
+		assert(std::abs(analyzer.samples("x")[b] - (sum - bin_sums[b]) / 48) < 1e-12);
+
+	JackknifeAnalyzer<std::string, double> resampled(6);
+	resampled.resample_replicas("x", x);
+	resampled.resample_replicas("y", replicas(1));
+	resampled.add_function("f", [](double x, double y) {return x / y;}, "x", "y");
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(2);
+	assert(rebinned.num_bins() == resampled.num_bins());
+	for (const std::string key : { "x", "y", "f" }) {
+		assert(std::abs(rebinned.mu(key) - resampled.mu(key)) < 1e-12);
+		assert(std::abs(rebinned.sigma(key) - resampled.sigma(key)) < 1e-12);
+	}
+
+	// samples [3, 18) of each replica
+	const JackknifeAnalyzer<std::string, double> reanalyzed = analyzer.reanalyze(5, 3, 18);
+	JackknifeAnalyzer<std::string, double> cut(5);
+	cut.resample_replicas("x", { std::vector<double>(x[0].begin() + 3, x[0].begin() + 18),
+			std::vector<double>(x[1].begin() + 3, x[1].begin() + 18) });
+	assert(reanalyzed.num_bins() == 6);
+	assert(std::abs(reanalyzed.mu("x") - cut.mu("x")) < 1e-12);
+	assert(std::abs(reanalyzed.sigma("x") - cut.sigma("x")) < 1e-12);
+
+	// the number of bins must match existing variables
+	bool thrown = false;
+	try {
+		analyzer.resample_replicas("z", { x[0] });
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+std::vector<double> data(std::size_t num_samples) {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < num_samples; ++i)
+		x.push_back(1 + 0.1 * std::sin(0.37 * i));
+	return x;
+}
+
+void compare_with_copied(std::size_t bin_size, bool retain_raw) {
+	// 2 samples are left over with bin size 3
+	const std::vector<double> x = data(50);
+	JackknifeAnalyzer<std::string, double> copied(bin_size), consumed(bin_size);
+	copied.retain_raw_histories(retain_raw);
+	consumed.retain_raw_histories(retain_raw);
+
+	copied.resample("x", x);
+	std::vector<double> samples = x;
+	consumed.resample("x", std::move(samples));
+	assert(samples.empty() && samples.capacity() == 0);
+
+	assert(consumed.mu("x") == copied.mu("x"));
+	assert(consumed.samples("x") == copied.samples("x"));
+	if (retain_raw)
+		assert(consumed.raw_history("x") == x);
+
+	// samples of existing keys are released as well
+	samples = data(50);
+	consumed.resample("x", std::move(samples));
+	assert(samples.capacity() == 0);
+	assert(consumed.samples("x") == copied.samples("x"));
+}
+
+}
+
+/**
+ * Resampling from a consumed vector gives the same results as from a copied one, with and without retained raw
+ * histories, and always releases the memory of the vector.
+ */
+int main() {
+	for (std::size_t bin_size : { 1, 3 })
+		for (bool retain_raw : { false, true })
+			compare_with_copied(bin_size, retain_raw);
+	return 0;
+}
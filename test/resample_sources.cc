@@ -0,0 +1,83 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+template<typename T>
+std::vector<T> data(std::size_t num_configs, std::size_t num_sources, double offset) {
+	std::vector<T> x;
+	for (std::size_t c = 0; c < num_configs; ++c)
+		for (std::size_t s = 0; s < num_sources; ++s)
+			x.push_back(offset + 0.1 * std::sin(0.37 * c) + 0.01 * std::cos(1.3 * s + 0.1 * c));
+	return x;
+}
+
+// jackknife error of the mean over sources, leaving out one source for all configurations, in double precision
+template<typename T>
+double sigma_sources(const std::vector<T>& x, std::size_t num_sources) {
+	const std::size_t num_configs = x.size() / num_sources;
+	std::vector<double> source_sums(num_sources, 0);
+	double sum = 0;
+	for (std::size_t c = 0; c < num_configs; ++c)
+		for (std::size_t s = 0; s < num_sources; ++s) {
+			source_sums[s] += x[c * num_sources + s];
+			sum += x[c * num_sources + s];
+		}
+	const double mu = sum / x.size();
+	double squares = 0;
+	for (std::size_t s = 0; s < num_sources; ++s)
+		squares += std::pow((sum - source_sums[s]) / (num_configs * (num_sources - 1)) - mu, 2);
+	return std::sqrt((num_sources - 1.) / num_sources * squares);
+}
+
+}
+
+/**
+ * Resampling over sources agrees with resampling the source averages, and the error over sources with leaving out
+ * one source at a time, also for float data with a large offset. A single source has no error over sources.
+ */
+int main() {
+	const std::size_t num_configs = 50, num_sources = 4;
+	const std::vector<double> x = data<double>(num_configs, num_sources, 1);
+	JackknifeAnalyzer<std::string, double> analyzer(3), averaged(3);
+	double sigma_x;
+	analyzer.resample_sources("x", x, num_sources, sigma_x);
+	assert(std::abs(sigma_x - sigma_sources(x, num_sources)) < 1e-12);
+
+	std::vector<double> averages(num_configs, 0);
+	for (std::size_t c = 0; c < num_configs; ++c)
+		for (std::size_t s = 0; s < num_sources; ++s)
+			averages[c] += x[c * num_sources + s] / num_sources;
+	averaged.resample("x", averages);
+	assert(analyzer.num_bins() == averaged.num_bins());
+	assert(std::abs(analyzer.mu("x") - averaged.mu("x")) < 1e-12);
+	for (std::size_t b = 0; b < analyzer.num_bins(); ++b)
+		assert(std::abs(analyzer.samples("x")[b] - averaged.samples("x")[b]) < 1e-12);
+
+	double sigma_single;
+	analyzer.resample_sources("y", data<double>(num_configs, 1, 2), 1, sigma_single);
+	assert(sigma_single == 0);
+
+	bool thrown = false;
+	try {
+		analyzer.resample_sources("z", data<double>(num_configs, num_sources, 1), 3);
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	const std::vector<float> y = data<float>(100000, num_sources, 1000);
+	JackknifeAnalyzer<std::string, float> single_precision;
+	float sigma_y;
+	single_precision.resample_sources("y", y, num_sources, sigma_y);
+	const double exact = sigma_sources(y, num_sources);
+	assert(std::abs(sigma_y - exact) < 1e-3 * exact);
+	return 0;
+}
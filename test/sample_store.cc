@@ -0,0 +1,83 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+template<typename Layout>
+void check_store() {
+	const std::size_t slot_size = 5, L = Layout::lanes;
+	SampleStore<double, Layout> store(slot_size, 4 * L * slot_size * sizeof(double));
+	assert(store.page_size() == 4 * L);
+
+	std::vector<std::size_t> slots;
+	for (std::size_t s = 0; s < 3 * store.page_size(); ++s) {
+		slots.push_back(store.allocate());
+		std::vector<double> elements(slot_size, static_cast<double>(slots.back()));
+		store.write(slots.back(), elements.data());
+	}
+	assert(store.capacity() == 3 * store.page_size());
+
+	// released slots are recycled before new ones, and a page without used slots is freed
+	store.release(slots[1]);
+	assert(store.allocate() == slots[1]);
+	for (std::size_t s = 0; s < store.page_size(); ++s)
+		store.release(slots[s]);
+	assert(store.capacity() == 2 * store.page_size());
+
+	// copies share pages until either writes
+	const SampleStore<double, Layout> copy = store;
+	const std::size_t last = slots.back();
+	std::vector<double> elements(slot_size, -1);
+	store.write(last, elements.data());
+	copy.read(last, elements.data());
+	assert(elements[0] == static_cast<double>(last));
+
+	std::size_t lane;
+	const double* tile = store.tile_data(last, lane);
+	assert(lane == last % L && tile[lane] == -1);
+
+	// compacting moves the used slots into the freed ones without changing their data
+	store.release(slots[store.page_size() + 2]);
+	const std::vector<std::size_t> new_slots = store.compact();
+	assert(store.size() == 2 * store.page_size() - 1 && store.capacity() == 2 * store.page_size());
+	for (std::size_t s = store.page_size(); s < slots.size(); ++s) {
+		if (s == store.page_size() + 2)
+			continue;
+		assert(new_slots[slots[s]] < store.size());
+		store.read(new_slots[slots[s]], elements.data());
+		assert(elements[slot_size - 1] == (slots[s] == last ? -1 : static_cast<double>(slots[s])));
+	}
+}
+
+}
+
+/**
+ * SampleStore recycles released slots, frees empty pages, shares pages between copies until they are written and
+ * compacts without changing data, for both layouts. The analyzer keeps its samples when removing and compacting.
+ */
+int main() {
+	check_store<contiguous_slots>();
+	check_store<slot_tiles<4> >();
+
+	JackknifeAnalyzer<std::string, double> analyzer;
+	for (std::size_t k = 0; k < 100; ++k) {
+		std::vector<double> x;
+		for (std::size_t i = 0; i < 50; ++i)
+			x.push_back(std::cos(0.01 * (i + 1) * (k + 1)));
+		analyzer.resample("x" + std::to_string(k), x);
+	}
+	const std::vector<double> x99 = analyzer.samples("x99");
+	for (std::size_t k = 0; k < 99; k += 2)
+		analyzer.remove("x" + std::to_string(k));
+	analyzer.compact();
+	assert(analyzer.samples("x99") == x99);
+	analyzer.add_function("f", [](double x) {return 2 * x;}, "x99");
+	assert(analyzer.samples("f")[7] == 2 * x99[7]);
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include "SharedAnalyzer.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::string segment_name = "/jackknife_analyzer_test_" + std::to_string(getpid());
+
+std::string key_name(const std::string& key) {
+	return key;
+}
+
+template<typename T>
+JackknifeAnalyzer<std::string, T> analyzer(std::size_t num_samples, double offset) {
+	JackknifeAnalyzer<std::string, T> a;
+	std::vector<T> x, y;
+	for (std::size_t i = 0; i < num_samples; ++i) {
+		x.push_back(offset + std::sin(0.37 * i));
+		y.push_back(offset + std::sin(0.37 * i) + 0.5 * std::cos(1.1 * i));
+	}
+	a.resample("x", x);
+	a.resample("y", y);
+	return a;
+}
+
+template<typename T>
+bool attach_throws() {
+	try {
+		SharedAnalyzer<T> shared(segment_name);
+	} catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+// overwrites the 64 bit field at offset of the published segment
+void damage(std::size_t offset, std::uint64_t value) {
+	const int fd = shm_open(segment_name.c_str(), O_RDWR, 0);
+	assert(fd >= 0);
+	void* mapped = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	assert(mapped != MAP_FAILED);
+	std::memcpy(static_cast<unsigned char*>(mapped) + offset, &value, sizeof(value));
+	munmap(mapped, 4096);
+}
+
+}
+
+/**
+ * Attached views agree with the published analyzer and keep their state when it is published again. Segments of a
+ * different value type, incompletely published segments and segments with offsets beyond their size are rejected.
+ * Covariances of float data with many bins keep float precision.
+ */
+int main() {
+	JackknifeAnalyzer<std::string, double> published = analyzer<double>(40, 1);
+	published.add_function("f", [](double x, double y) {return x * y;}, "x", "y");
+	published.add_terminal_function("t", [](double x) {return 2 * x;}, "x");
+	SharedAnalyzer<double>::publish<std::string>(segment_name, published, key_name);
+
+	{
+		const SharedAnalyzer<double> shared(segment_name);
+		assert(shared.num_bins() == published.num_bins());
+		assert(shared.keys() == std::vector<std::string>( { "f", "t", "x", "y" }));
+		for (const std::string key : { "f", "t", "x", "y" }) {
+			assert(shared.mu(key) == published.mu(key));
+			assert(shared.sigma(key) == published.sigma(key));
+			assert(shared.bias(key) == published.bias(key));
+		}
+		const std::vector<double> f_samples = published.samples("f");
+		assert(std::equal(f_samples.begin(), f_samples.end(), shared.samples("f")));
+		assert(std::abs(shared.covariance("x", "y") - published.covariance("x", "y")) < 1e-14);
+
+		bool thrown = false;
+		try {
+			shared.samples("t");
+		} catch (const std::runtime_error&) {
+			thrown = true;
+		}
+		assert(thrown);
+		double mu, sigma;
+		assert(!shared.jackknife("unknown", mu, sigma));
+
+		// the attached view keeps the previous segment
+		SharedAnalyzer<double>::publish<std::string>(segment_name, analyzer<double>(40, 2), key_name);
+		assert(shared.mu("f") == published.mu("f"));
+		assert(SharedAnalyzer<double>(segment_name).keys().size() == 2);
+	}
+	assert(attach_throws<float>());
+
+	// magic number, value size, number of keys, names offset, samples offset
+	damage(0, 0);
+	assert(attach_throws<double>());
+	for (const std::size_t field : { 3, 4, 5 }) {
+		SharedAnalyzer<double>::publish<std::string>(segment_name, published, key_name);
+		damage(field * sizeof(std::uint64_t), 1000000);
+		assert(attach_throws<double>());
+	}
+
+	// name length of the first key and samples row of the second key, after the header of 6 fields and with
+	// 6 fields per key
+	SharedAnalyzer<double>::publish<std::string>(segment_name, published, key_name);
+	damage(7 * sizeof(std::uint64_t), 1000000);
+	assert(attach_throws<double>());
+	SharedAnalyzer<double>::publish<std::string>(segment_name, published, key_name);
+	damage(14 * sizeof(std::uint64_t), 1000);
+	assert(attach_throws<double>());
+
+	const std::size_t N_float = 200000;
+	const JackknifeAnalyzer<std::string, float> single_precision = analyzer<float>(N_float, 1);
+	SharedAnalyzer<float>::publish<std::string>(segment_name, single_precision, key_name);
+	const SharedAnalyzer<float> shared(segment_name);
+	double exact = 0;
+	for (std::size_t i = 0; i < N_float; ++i)
+		exact += ((double) shared.samples("x")[i] - shared.mu("x"))
+				* ((double) shared.samples("y")[i] - shared.mu("y"));
+	exact *= (N_float - 1.) / N_float;
+	assert(std::abs(shared.covariance("x", "y") - exact) < 1e-6 * std::abs(exact));
+
+	SharedAnalyzer<double>::unlink(segment_name);
+	assert(attach_throws<double>());
+	return 0;
+}
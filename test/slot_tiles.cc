@@ -0,0 +1,70 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::size_t N_keys = 10;
+
+std::vector<double> data(double phase) {
+	std::vector<double> x;
+	for (std::size_t i = 0; i < 24; ++i)
+		x.push_back(1 + 0.1 * std::sin(0.37 * i + phase) + 0.02 * std::cos(1.3 * i * phase));
+	return x;
+}
+
+std::vector<std::string> keys(const std::string& name, std::size_t num_keys) {
+	std::vector<std::string> names;
+	for (std::size_t k = 0; k < num_keys; ++k)
+		names.push_back(name + std::to_string(k));
+	return names;
+}
+
+template<typename Layout>
+JackknifeAnalyzer<std::string, double, Layout> analyze() {
+	JackknifeAnalyzer<std::string, double, Layout> analyzer;
+	for (std::size_t k = 0; k < N_keys; ++k)
+		analyzer.resample("x" + std::to_string(k), data(k));
+	analyzer.add_function("f", [](double x0, double x5) {return x0 / x5;}, "x0", "x5");
+
+	std::vector<double> coefficients;
+	for (std::size_t o = 0; o < 3; ++o)
+		for (std::size_t k = 0; k < N_keys; ++k)
+			coefficients.push_back(std::cos(0.7 * o * k));
+	analyzer.add_linear_combinations(keys("p", 3), coefficients, keys("x", N_keys));
+
+	// leaves a hole in a tile, which is recycled by the next variable
+	analyzer.remove("f");
+	analyzer.resample("y", data(N_keys));
+	return analyzer;
+}
+
+}
+
+/**
+ * An analyzer storing its samples in tiles of 4 variables agrees exactly with one storing them contiguously, for
+ * resampled and derived variables, after removing variables and after rebinning. sigmas(...) agrees with sigma(...).
+ */
+int main() {
+	const JackknifeAnalyzer<std::string, double> contiguous = analyze<contiguous_slots>();
+	const JackknifeAnalyzer<std::string, double, slot_tiles<4> > tiled = analyze<slot_tiles<4> >();
+	const JackknifeAnalyzer<std::string, double> contiguous_rebinned = contiguous.rebin(2);
+	const JackknifeAnalyzer<std::string, double, slot_tiles<4> > tiled_rebinned = tiled.rebin(2);
+
+	const std::vector<std::string> all_keys = tiled.keys();
+	assert(all_keys == contiguous.keys());
+	const std::vector<double> sigmas = tiled.sigmas(all_keys);
+	for (std::size_t k = 0; k < all_keys.size(); ++k) {
+		const std::string& key = all_keys[k];
+		assert(tiled.mu(key) == contiguous.mu(key));
+		assert(tiled.samples(key) == contiguous.samples(key));
+		assert(std::abs(sigmas[k] - contiguous.sigma(key)) <= 1e-15 * contiguous.sigma(key));
+		assert(tiled_rebinned.samples(key) == contiguous_rebinned.samples(key));
+	}
+	return 0;
+}
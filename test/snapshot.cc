@@ -0,0 +1,75 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+using analyzer_type = JackknifeAnalyzer<std::string, double>;
+
+const std::size_t N_keys = 12, N_bins = 40;
+
+void add_inputs(analyzer_type& analyzer) {
+	for (std::size_t k = 0; k < N_keys; ++k) {
+		std::vector<double> x;
+		for (std::size_t i = 0; i < N_bins; ++i)
+			x.push_back(1 + 0.1 * std::sin(0.3 * (i + 1) * (k + 1)));
+		analyzer.resample("x" + std::to_string(k), x);
+	}
+}
+
+// adds one function of each pair of inputs and compares all variables with the unbudgeted reference
+void derive_and_compare(analyzer_type& analyzer, const analyzer_type& reference, const std::string& prefix) {
+	for (std::size_t k = 0; k + 1 < N_keys; ++k) {
+		const std::string key = prefix + std::to_string(k);
+		analyzer.add_function(key, [](double x, double y) {return x / y;}, "x" + std::to_string(k),
+				"x" + std::to_string(k + 1));
+		assert(analyzer.mu(key) == reference.mu(key));
+		assert(analyzer.sigma(key) == reference.sigma(key));
+	}
+	for (const std::string& key : analyzer.keys())
+		assert(analyzer.samples(key) == reference.samples(key));
+}
+
+}
+
+/**
+ * Snapshots of an analyzer with a memory budget keep their own LRU order, so both the snapshot and the original
+ * can add, spill and page in variables independently, also concurrently, and copy assignment does the same.
+ */
+int main() {
+	analyzer_type reference;
+	add_inputs(reference);
+	for (std::size_t k = 0; k + 1 < N_keys; ++k)
+		for (const std::string prefix : { "f", "g", "h" })
+			reference.add_function(prefix + std::to_string(k), [](double x, double y) {return x / y;},
+					"x" + std::to_string(k), "x" + std::to_string(k + 1));
+
+	analyzer_type original;
+	original.set_memory_budget(3 * N_bins * sizeof(double), "snapshot.scratch");
+	add_inputs(original);
+
+	analyzer_type snapshot = original.snapshot();
+	derive_and_compare(snapshot, reference, "f");
+	derive_and_compare(original, reference, "g");
+	assert(snapshot.keys().size() == 2 * N_keys - 1 && original.keys().size() == 2 * N_keys - 1);
+
+	analyzer_type concurrent_snapshot = original.snapshot();
+	std::thread worker([&concurrent_snapshot, &reference]() {
+		derive_and_compare(concurrent_snapshot, reference, "h");
+	});
+	for (std::size_t k = 0; k < N_keys; ++k)
+		assert(original.sigma("x" + std::to_string(k)) == reference.sigma("x" + std::to_string(k)));
+	worker.join();
+
+	analyzer_type assigned;
+	assigned = original;
+	derive_and_compare(assigned, reference, "h");
+	derive_and_compare(original, reference, "f");
+	return 0;
+}
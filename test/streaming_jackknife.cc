@@ -0,0 +1,100 @@
+#include "JackknifeAnalyzer.hh"
+#include "StreamingJackknife.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+namespace {
+
+const std::size_t window_bins = 8, bin_size = 3;
+
+double sample(std::size_t i) {
+	return 10 + 0.01 * i + std::sin(0.37 * i);
+}
+
+// resamples the complete bins in the window from the first i samples of the stream
+void compare_with_resampled(const StreamingJackknife<double>& stream, std::size_t i) {
+	const std::size_t complete_samples = i / bin_size * bin_size;
+	const std::size_t first = complete_samples - stream.num_bins() * bin_size;
+	std::vector<double> window;
+	for (std::size_t j = first; j < complete_samples; ++j)
+		window.push_back(sample(j));
+	const JackknifeAnalyzer<std::string, double> resampled("x", window, bin_size);
+
+	double mu, sigma;
+	assert(stream.jackknife(mu, sigma));
+	assert(std::abs(mu - resampled.mu("x")) < 1e-12);
+	assert(std::abs(sigma - resampled.sigma("x")) < 1e-12);
+	assert(mu == stream.mu() && sigma == stream.sigma());
+	for (std::size_t b = 0; b < stream.num_bins(); ++b)
+		assert(std::abs(stream.samples()[b] - resampled.samples("x")[b]) < 1e-12);
+}
+
+// float samples drifting through a large window, compared with resampling them in double precision
+void compare_float_with_resampled() {
+	const std::size_t large_window_bins = 16384;
+	StreamingJackknife<float> stream(large_window_bins);
+	std::vector<double> window;
+	for (std::size_t i = 0; i < 5 * large_window_bins / 2; ++i) {
+		const float x = static_cast<float>(1000 + 200. * i / large_window_bins + std::sin(0.37 * i));
+		stream.add(x);
+		if (i >= 3 * large_window_bins / 2)
+			window.push_back(x);
+	}
+	const JackknifeAnalyzer<std::string, double> resampled("x", window);
+
+	float mu, sigma;
+	assert(stream.jackknife(mu, sigma));
+	assert(std::abs(mu - resampled.mu("x")) < 1e-6 * resampled.mu("x"));
+	assert(std::abs(sigma - resampled.sigma("x")) < 2e-7 * resampled.sigma("x"));
+}
+
+template<typename Function>
+bool throws(Function f) {
+	try {
+		f();
+	} catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+}
+
+/**
+ * While the window fills up and after it starts sliding, mean, error and jackknife samples of the stream agree with
+ * resampling the complete bins in the window, also after the running sums were recomputed many times. The error of a
+ * float stream drifting through a large window is accurate to float precision.
+ */
+int main() {
+	assert(throws([] {StreamingJackknife<double>(1);}));
+	assert(throws([] {StreamingJackknife<double>(4, 0);}));
+
+	StreamingJackknife<double> stream(window_bins, bin_size);
+	double mu, sigma;
+	for (std::size_t i = 0; i < 2 * bin_size - 1; ++i)
+		stream.add(sample(i));
+	assert(stream.num_bins() == 1);
+	assert(!stream.jackknife(mu, sigma));
+	assert(throws([&stream] {stream.mu();}));
+
+	std::size_t i = 2 * bin_size - 1;
+	for (; i < 1000; ++i) {
+		stream.add(sample(i));
+		if (i % 7 == 0)
+			compare_with_resampled(stream, i + 1);
+	}
+	assert(stream.num_bins() == window_bins);
+
+	for (; i < 100000; ++i)
+		stream.add(sample(i));
+	compare_with_resampled(stream, i);
+
+	compare_float_with_resampled();
+	return 0;
+}
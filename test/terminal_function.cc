@@ -0,0 +1,59 @@
+#include "JackknifeAnalyzer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace de_uni_frankfurt_itp::reisinger::jackknife_analyzer_0219;
+
+/**
+ * A terminal function has the same mean, error and bias as the same function added with add_function(...), but
+ * keeps no samples and cannot be used as argument.
+ */
+int main() {
+	std::vector<double> x, y;
+	for (std::size_t i = 0; i < 3000; ++i) {
+		x.push_back(1 + 0.1 * std::sin(0.37 * i));
+		y.push_back(2 + 0.1 * std::cos(0.11 * i));
+	}
+
+	JackknifeAnalyzer<std::string, double> analyzer(2);
+	analyzer.resample("x", x);
+	analyzer.resample("y", y);
+	const auto ratio = [](double x, double y) {return x / y;};
+	analyzer.add_function("f", ratio, "x", "y");
+	analyzer.add_terminal_function("t", ratio, "x", "y");
+	analyzer.add_terminal_function("v", [](std::vector<double> xy) {return xy[0] / xy[1];}, std::vector<std::string> {
+			"x", "y" });
+
+	for (const std::string key : { "t", "v" }) {
+		assert(analyzer.is_terminal(key));
+		assert(analyzer.mu(key) == analyzer.mu("f"));
+		assert(std::abs(analyzer.sigma(key) - analyzer.sigma("f")) < 1e-12 * analyzer.sigma("f"));
+		assert(std::abs(analyzer.bias(key) - analyzer.bias("f")) < 1e-12);
+	}
+	assert(!analyzer.is_terminal("f") && !analyzer.is_terminal("missing"));
+
+	bool threw = false;
+	try {
+		analyzer.samples("t");
+	} catch (const std::runtime_error&) {
+		threw = true;
+	}
+	assert(threw);
+
+	threw = false;
+	try {
+		analyzer.add_function("g", [](double t) {return t;}, "t");
+	} catch (const std::out_of_range&) {
+		threw = true;
+	}
+	assert(threw && analyzer.keys().size() == 5);
+
+	const JackknifeAnalyzer<std::string, double> rebinned = analyzer.rebin(3);
+	assert(rebinned.is_terminal("t"));
+	assert(std::abs(rebinned.mu("t") - analyzer.mu("t")) < 1e-12);
+	return 0;
+}